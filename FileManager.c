@@ -1,24 +1,517 @@
 
 #include "FileManager.h"
+#include "FileManagerLZ.h"
+#include "FileManagerCRC.h"
+#include "FileManagerSwap.h"
 
 /* Private Variable */
 FileManager* lastFile     = FILE_MANAGER_NULL;
-const FileManager_Driver*   fileManagerDriver;
+static FileManager*         readyHead    = FILE_MANAGER_NULL;
+static FileManager*         readyTail    = FILE_MANAGER_NULL;
+static FileManager*         fileTable[FILE_MANAGER_FILE_TABLE_SIZE];
+FileManager_Volume*         lastVolume   = FILE_MANAGER_VOLUME_NULL;
+static FileManager_Volume   defaultVolume;
+static uint8_t              fillBuffer[FILE_MANAGER_FILL_BUFFER_SIZE];
+static int16_t              fillBufferPattern = -1;
+static uint32_t             copyBuffer[2][FILE_MANAGER_COPY_BUFFER_SIZE / sizeof(uint32_t)];   ///// word aligned for DMA
+static uint64_t             swapBuffer[FILE_MANAGER_SWAP_BUFFER_SIZE / sizeof(uint64_t)];      ///// aligned for 64bit elements
+static FileManager_yieldFn  yieldFn      = NULL;
+static void*                yieldArgs    = NULL;
 
 
 
 
 /**
- * @brief this Function use for Initial the Driver
+ * @brief this Function use for Initial the Driver of default volume, Files use default volume until File_setVolume
  * 
  * @param driver Address of FileManagerDriver 
  */
 void FileManager_Init(const FileManager_Driver* driver) {
-    fileManagerDriver = driver;
+    if (defaultVolume.Driver == NULL) {
+        FileManager_addVolume(&defaultVolume, driver, NULL);
+    }
+    defaultVolume.Driver = driver;
+}
+
+
+
+/**
+ * @brief add one more storage device (SdCard, eMMC, ...) with its own Driver and mount state
+ * 
+ * @param volume  Address of FileManager_Volume
+ * @param driver  Address of FileManagerDriver of device
+ * @param context port data of device (e.g. FATFS and Path), driver get it from volume->Context
+ */
+void FileManager_addVolume (FileManager_Volume* volume, const FileManager_Driver* driver, void* context) {
+    volume->Driver   = driver;
+    volume->Context  = context;
+    volume->Mounted  = 0;
+    volume->Previous = lastVolume;
+    lastVolume       = volume;
+}
+
+
+
+/**
+ * @brief Mount volume if it is not mounted, volume stay mounted until it is not detected or report disk error
+ * 
+ * @param volume Address of FileManager_Volume
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_mount (FileManager_Volume* volume) {
+    FileManager_Result result = FileManager_OK;
+    if (!volume->Mounted) {
+        result          = volume->Driver->Mount(volume, FileManager_ForceMount);
+        volume->Mounted = result == FileManager_OK;
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief check volume is detected, volume which is removed must be Mounted again (same as FileManager_handle)
+ * 
+ * @param volume Address of FileManager_Volume
+ * @return uint8_t result of driver IsDetected
+ */
+static uint8_t FileManager_detect (FileManager_Volume* volume) {
+    uint8_t detected = volume->Driver->IsDetected(volume);
+    if (!detected) {
+        volume->Mounted = 0;
+    }
+    return detected;
+}
+
+
+
+
+/**
+ * @brief FNV-1a hash of Path, select Bucket of Path table
+ */
+static uint32_t FileManager_hashPath (const uint8_t* path) {
+    uint32_t hash = 2166136261UL;
+    while (*path != 0) {
+        hash ^= *path++;
+        hash *= 16777619UL;
+    }
+    return hash & (FILE_MANAGER_FILE_TABLE_SIZE - 1);
+}
+
+
+
+static void FileManager_linkPath (FileManager* file) {
+    uint32_t bucket   = FileManager_hashPath(file->Path);
+    file->HashNext    = fileTable[bucket];
+    fileTable[bucket] = file;
+}
+
+
+
+static void FileManager_unlinkPath (FileManager* file) {
+    FileManager** pLink = &fileTable[FileManager_hashPath(file->Path)];
+    while (*pLink != FILE_MANAGER_NULL && *pLink != file) {
+        pLink = &(*pLink)->HashNext;
+    }
+    if (*pLink == file) {
+        *pLink = file->HashNext;
+    }
+    file->HashNext = FILE_MANAGER_NULL;
+}
+
+
+
+/**
+ * @brief put File at end of ready-list, FileManager_handle only visit Files of ready-list
+ * 
+ * @param file Address of FileManager
+ */
+static void FileManager_makeReady (FileManager* file) {
+    if (file->Ready) {
+        return;
+    }
+    file->Ready     = 1;
+    file->ReadyNext = FILE_MANAGER_NULL;
+    file->ReadyPrev = readyTail;
+    if (readyTail == FILE_MANAGER_NULL) {
+        readyHead = file;
+    }
+    else {
+        readyTail->ReadyNext = file;
+    }
+    readyTail = file;
+}
+
+
+
+/**
+ * @brief remove File from ready-list (ready-list is doubly linked, no walk)
+ */
+static void FileManager_unready (FileManager* file) {
+    if (file->ReadyPrev == FILE_MANAGER_NULL) {
+        readyHead = file->ReadyNext;
+    }
+    else {
+        file->ReadyPrev->ReadyNext = file->ReadyNext;
+    }
+    if (file->ReadyNext == FILE_MANAGER_NULL) {
+        readyTail = file->ReadyPrev;
+    }
+    else {
+        file->ReadyNext->ReadyPrev = file->ReadyPrev;
+    }
+    file->ReadyNext = FILE_MANAGER_NULL;
+    file->ReadyPrev = FILE_MANAGER_NULL;
+    file->Ready     = 0;
+}
+
+
+
+/**
+ * @brief give command next Id, put it into CommandQueue and File into ready-list, onCapture see each queued command
+ * 
+ * @return FileManager_Result FileManager_NOT_ENOUGH_CORE if CommandQueue is full (command is not queued)
+ */
+static FileManager_Result FileManager_enqueue (FileManager* file, FileManager_CommandHeader* command) {
+    if (Queue_space(&file->CommandQueue) == 0) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    command->Id = ++file->LastId;
+    Queue_writeItem(&file->CommandQueue, command);
+    FileManager_makeReady(file);
+    if (file->Callbacks.onCapture != NULL) {
+        file->Callbacks.onCapture(file, command);
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief write Bytes of command into WriteStream, WriteTotal count them so pending writes know their place in WriteStream
+ */
+static void FileManager_streamWrite (FileManager* file, uint8_t* data, int32_t len) {
+    int32_t available = Stream_available(&file->WriteStream);
+    Stream_writeBytes(&file->WriteStream, data, len);
+    file->WriteTotal += Stream_available(&file->WriteStream) - available;
+}
+
+
+
+/**
+ * @brief check command is canceled by File_cancel (or replaced by dedupe)
+ */
+static uint8_t FileManager_isCanceled (FileManager* file, uint32_t id) {
+    uint8_t i;
+    for (i = 0; i < file->CancelCount; i++) {
+        if (file->Canceled[i] == id) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+
+/**
+ * @brief drop pending writes whose Data left WriteStream (it is in driver now)
+ */
+static void FileManager_pendingRetire (FileManager* file) {
+    uint32_t             readPos = file->WriteTotal - (uint32_t)Stream_available(&file->WriteStream);
+    FileManager_Pending* pending;
+    while (file->PendingCount > 0) {
+        pending = &file->Pending[file->PendingHead];
+        if ((int32_t)(pending->Offset - readPos) + pending->Len > 0) {
+            break;
+        }
+        file->PendingHead = (file->PendingHead + 1) % file->PendingLen;
+        file->PendingCount--;
+    }
+}
+
+
+
+/**
+ * @brief check pending map can take one more write (File without map always can)
+ */
+static uint8_t FileManager_pendingSpace (FileManager* file) {
+    if (file->Pending == NULL) {
+        return 1;
+    }
+    FileManager_pendingRetire(file);
+    return file->PendingCount < file->PendingLen;
+}
+
+
+
+/**
+ * @brief add write command to pending map (Data start at offset of WriteStream),
+ *        append which continue last pending append in WriteStream extend it
+ * 
+ * @return uint8_t 0 -> pending map is full
+ */
+static uint8_t FileManager_pendingAdd (FileManager* file, FileManager_Addr addr, int32_t len, uint32_t offset, uint32_t id) {
+    FileManager_Pending* pending;
+    if (file->Pending == NULL || len < 1) {
+        return 1;
+    }
+    FileManager_pendingRetire(file);
+    if (file->PendingCount > 0) {
+        pending = &file->Pending[(file->PendingHead + file->PendingCount - 1) % file->PendingLen];
+        if (pending->Offset + pending->Len == offset && addr == END_OF_FILE && pending->Addr == END_OF_FILE) {
+            pending->Len += len;
+            pending->Id   = id;
+            return 1;
+        }
+    }
+    if (file->PendingCount == file->PendingLen) {
+        return 0;
+    }
+    pending         = &file->Pending[(file->PendingHead + file->PendingCount) % file->PendingLen];
+    pending->Addr   = addr;
+    pending->Len    = len;
+    pending->Offset = offset;
+    pending->Id     = id;
+    file->PendingCount++;
+    return 1;
+}
+
+
+
+/**
+ * @brief walk pending writes in queue order, Bytes which overlap [addr, addr + len) are copied into data (NULL -> no copy),
+ *        END_OF_FILE writes start at end of File (size) and previous writes
+ * 
+ * @param size Size of File on card, -1 -> not known (return addr if any END_OF_FILE write is pending)
+ * @return FileManager_Addr end of range which is given by pending writes from addr
+ */
+static FileManager_Addr FileManager_pendingWalk (FileManager* file, FileManager_Addr addr, uint8_t* data, int32_t len, FileManager_Addr size) {
+    Stream               view;
+    FileManager_Pending* pending;
+    FileManager_Addr     end   = size;
+    FileManager_Addr     cover = addr;
+    FileManager_Addr     start;
+    FileManager_Addr     lo;
+    FileManager_Addr     hi;
+    uint32_t             readPos;
+    int32_t              skip;
+    uint16_t             i;
+
+    FileManager_pendingRetire(file);
+    readPos = file->WriteTotal - (uint32_t)Stream_available(&file->WriteStream);
+    for (i = 0; i < file->PendingCount; i++) {
+        pending = &file->Pending[(file->PendingHead + i) % file->PendingLen];
+        if (FileManager_isCanceled(file, pending->Id)) {
+            continue;
+        }
+        skip    = (int32_t)(readPos - pending->Offset);      ///// Bytes of command in process which are written
+        if (skip < 0) {
+            skip = 0;
+        }
+        if (pending->Addr != END_OF_FILE) {
+            start = pending->Addr + skip;
+        }
+        else if (end < 0) {
+            return addr;
+        }
+        else {
+            start = end;
+        }
+        if (end >= 0 && start + pending->Len - skip > end) {
+            end = start + pending->Len - skip;
+        }
+        lo = start > addr ? start : addr;
+        hi = start + pending->Len - skip < addr + len ? start + pending->Len - skip : addr + len;
+        if (lo < hi) {
+            if (data != NULL) {
+                view = file->WriteStream;                      ///// copy of Stream, WriteStream is not moved
+                Stream_moveReadPos(&view, (int32_t)(pending->Offset - readPos) + skip + (int32_t)(lo - start));
+                Stream_readBytes(&view, data + (lo - addr), (int32_t)(hi - lo));
+            }
+            if (lo <= cover && hi > cover) {
+                cover = hi;
+            }
+        }
+    }
+    return cover;
+}
+
+
+
+/**
+ * @brief check pending writes give all Bytes of [addr, addr + len)
+ */
+static uint8_t FileManager_pendingCovers (FileManager* file, FileManager_Addr addr, int32_t len, FileManager_Addr size) {
+    FileManager_Addr cover = addr;
+    FileManager_Addr last;
+    if (file->PendingCount == 0) {
+        return 0;
+    }
+    do {
+        last  = cover;
+        cover = FileManager_pendingWalk(file, cover, NULL, (int32_t)(addr + len - cover), size);
+    } while (cover > last && cover < addr + len);
+    return cover >= addr + len;
+}
+
+
+
+/**
+ * @brief check command id of File is done (its Bytes are on card and SyncPolicy of File is applied)
+ */
+static uint8_t FileManager_idDone (FileManager* file, uint32_t id) {
+    if ((int32_t)(id - file->StartedId) > 0 || (id == file->StartedId && file->CommandHeaderInProcess.Len > 0)) {
+        return 0;
+    }
+#if FILE_MANAGER_USE_ASYNC
+    if (file->AsyncCount > 0) {
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+
+
+/**
+ * @brief check last queued Fill/Const/Copy/Truncate is done
+ */
+static uint8_t FileManager_barrierDone (FileManager* file) {
+    return FileManager_idDone(file, file->BarrierId);
+}
+
+
+
+/**
+ * @brief keep range of command which change File without pending write (Fill, Const, Copy, Truncate), call it after command is queued
+ * 
+ * @param len Bytes from addr, -1 -> up to any size (Truncate)
+ */
+static void FileManager_barrierAdd (FileManager* file, FileManager_Addr addr, int32_t len) {
+    FileManager_Addr hi = len < 0 ? (FileManager_Addr)((FileManager_Size)-1 >> 1) : addr + len;
+    if (file->Pending == NULL) {
+        return;
+    }
+    if (FileManager_barrierDone(file)) {
+        file->BarrierLo = 0;
+        file->BarrierHi = 0;
+    }
+    file->BarrierId = file->LastId;
+    if (addr == END_OF_FILE) {
+        return;                                             ///// append change only Bytes after end of File
+    }
+    if (file->BarrierLo >= file->BarrierHi) {
+        file->BarrierLo = addr;
+        file->BarrierHi = hi;
+    }
+    else {
+        file->BarrierLo = addr < file->BarrierLo ? addr : file->BarrierLo;
+        file->BarrierHi = hi > file->BarrierHi ? hi : file->BarrierHi;
+    }
+}
+
+
+
+/**
+ * @brief check Bytes of [addr, addr + len) can be changed by queued Fill/Const/Copy/Truncate which is not done,
+ *        then neither card nor pending writes have them (queued writes before it may be overwritten), Blocking read must wait for drain,
+ *        Bytes after end of File are changed too (it can move end of File and so place of pending appends)
+ * 
+ * @param size Size of File on card, -1 -> not known
+ */
+static uint8_t FileManager_pendingBarrier (FileManager* file, FileManager_Addr addr, int32_t len, FileManager_Addr size) {
+    if (FileManager_barrierDone(file)) {
+        return 0;
+    }
+    return (addr < file->BarrierHi && file->BarrierLo < addr + len) || size < 0 || addr + len > size;
+}
+
+
+
+/**
+ * @brief check all commands queued after pending write i are pending writes with Address which do not touch [addr, addr + len)
+ */
+static uint8_t FileManager_pendingLast (FileManager* file, uint16_t i, FileManager_Addr addr, int32_t len) {
+    FileManager_Pending* pending = &file->Pending[(file->PendingHead + i) % file->PendingLen];
+    FileManager_Pending* later;
+    if (file->LastId - pending->Id != (uint32_t)(file->PendingCount - 1 - i)) {
+        return 0;                                           ///// other commands (Const, fill, copy, joined appends) are after it
+    }
+    while (++i < file->PendingCount) {
+        later = &file->Pending[(file->PendingHead + i) % file->PendingLen];
+        if (!FileManager_isCanceled(file, later->Id) &&
+            (later->Addr == END_OF_FILE || (later->Addr < addr + len && addr < later->Addr + later->Len))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
+/**
+ * @brief last writer win for new write of [addr, addr + len), queued write which has all of range and no later command touch it
+ *        take new Data in place of its Data in WriteStream, not when onComplete is set (new write would have no completion)
+ * 
+ * @return uint8_t 1 -> Data is written in place, no new command is needed
+ */
+static uint8_t FileManager_dedupe (FileManager* file, FileManager_Addr addr, uint8_t* data, int32_t len) {
+    Stream               view;
+    FileManager_Pending* pending;
+    uint32_t             readPos;
+    int32_t              tempLen;
+    uint16_t             i;
+
+    if (file->Callbacks.onComplete != NULL) {
+        return 0;
+    }
+    FileManager_pendingRetire(file);
+    readPos = file->WriteTotal - (uint32_t)Stream_available(&file->WriteStream);
+    for (i = file->PendingCount; i-- > 0; ) {
+        pending = &file->Pending[(file->PendingHead + i) % file->PendingLen];
+        if (pending->Addr == END_OF_FILE || (int32_t)(pending->Id - file->StartedId) <= 0 || FileManager_isCanceled(file, pending->Id)) {
+            continue;                                       ///// append, started or dropped command
+        }
+        if (pending->Addr <= addr && addr + len <= pending->Addr + pending->Len && FileManager_pendingLast(file, i, addr, len)) {
+            view = file->WriteStream;
+            Stream_moveReadPos(&view, (int32_t)(pending->Offset - readPos) + (int32_t)(addr - pending->Addr));
+            file->Stats.DroppedBytes += len;
+            while (len > 0) {
+                tempLen = len < Stream_directAvailable(&view) ? len : Stream_directAvailable(&view);
+                memcpy(Stream_getReadPtr(&view), data, tempLen);
+                Stream_moveReadPos(&view, tempLen);
+                data += tempLen;
+                len  -= tempLen;
+            }
+            return 1;
+        }
+    }
+    return 0;
 }
 
 
 
+/**
+ * @brief cancel queued writes which are not started and are all in range of new write (last queued command),
+ *        call it after new write is queued so a refused write never drop older Data
+ */
+static void FileManager_dedupeCancel (FileManager* file, FileManager_Addr addr, int32_t len) {
+    FileManager_Pending* pending;
+    uint16_t             i;
+
+    for (i = file->PendingCount; i-- > 0; ) {
+        pending = &file->Pending[(file->PendingHead + i) % file->PendingLen];
+        if (pending->Id == file->LastId || pending->Addr == END_OF_FILE || (int32_t)(pending->Id - file->StartedId) <= 0 ||
+            FileManager_isCanceled(file, pending->Id)) {
+            continue;                                       ///// new, append, started or dropped command
+        }
+        if (addr <= pending->Addr && pending->Addr + pending->Len <= addr + len) {
+            File_cancel(file, pending->Id);
+        }
+    }
+}
+
+
 
 /**
  * @brief This Function use to add FileManger Stuct into LinkedList
@@ -27,20 +520,34 @@ void FileManager_Init(const FileManager_Driver* driver) {
  * @param fil Address Of FIL struct(FatFs Library struct)
  * @param config Address of your FileManager Config
  * @param path the Path of File in SdCard ( Like "FileName.txt")
- * @return FileManager_Result 
+ * @return FileManager_Result FileManager_INVALID_PARAMETER if path or config is NULL
  */
 FileManager_Result FileManager_add (FileManager* file, FileManager_Fil* fil, const FileManager_Config* config, uint8_t* path) {
     if (FILE_MANAGER_NULL == file) {
         return FileManager_NO_FILE;
     }
+    if (path == NULL || config == NULL) {
+        return FileManager_INVALID_PARAMETER;               ///// Path is hashed here and config is used by every command
+    }
     file->Previous                    = lastFile;
+    file->Next                        = FILE_MANAGER_NULL;
+    if (lastFile != FILE_MANAGER_NULL) {
+        lastFile->Next                = file;
+    }
     lastFile                          = file;
+    file->ReadyNext                   = FILE_MANAGER_NULL;
+    file->ReadyPrev                   = FILE_MANAGER_NULL;
+    file->Ready                       = 0;
     file->Path                        = path;
+    FileManager_linkPath(file);
     file->Config                      = config;
     file->Context                     = fil;
+    file->Volume                      = &defaultVolume;
     file->CommandHeaderInProcess.Len  = 0;
     file->CommandHeaderInProcess.Addr = 0;
     file->Enabled                     = 1;
+    file->FileStatus                  = FileManager_FileIsClose;
+    file->OtherPath                   = 0;
     return FileManager_OK;
 }
 
@@ -71,136 +578,2286 @@ void File_init(FileManager* file, uint8_t* commandQBuffer, uint16_t commandQLen,
     file->CommandHeaderInProcess.Mode      = 0;
     memset(&file->CommandHeaderInProcess.DT, 0, sizeof(DateTime_X));
     file->PendingByte                      = 0;
+    file->SyncPolicy                       = FileManager_SyncOnClose;
+    file->SyncThreshold                    = 0;
+    file->DirtyBytes                       = 0;
+    file->Dirty                            = 0;
+    file->Compress                         = NULL;
+    file->Pending                          = NULL;
+    file->WriteTotal                       = 0;
+    file->PendingLen                       = 0;
+    file->PendingHead                      = 0;
+    file->PendingCount                     = 0;
+    file->LastId                           = 0;
+    file->StartedId                        = 0;
+    file->BarrierId                        = 0;
+    file->BarrierLo                        = 0;
+    file->BarrierHi                        = 0;
+    file->CancelCount                      = 0;
+    file->Dedupe                           = 0;
+    file->AlignRun                         = 0;
+    file->AlignPos                         = -1;
+    file->AlignPhys                        = 0;
+    file->AlignHeld                        = 0;
+    file->AlignFlush                       = 0;
+#if FILE_MANAGER_USE_ASYNC
+    file->AsyncBytes                       = 0;
+    file->AsyncHead                        = 0;
+    file->AsyncCount                       = 0;
+    file->AsyncWait                        = 0;
+    file->AsyncRead                        = 0;
+    file->AsyncResult                      = FileManager_OK;
+#endif
+    file->Framing                          = 0;
+    file->FrameOpen                        = 0;
+    file->Marker                           = FILE_MANAGER_NULL;
+    file->CheckpointEnd                    = 0;
+    file->CheckpointNext                   = 0;
+    file->CheckpointId                     = 0;
+    file->CheckpointSpacing                = 0;
+    file->CheckpointSeq                    = 0;
+    memset(&file->Stats, 0, sizeof(file->Stats));
 }
 
 
 
 
+/**
+ * @brief count written Bytes which are not durable yet
+ * 
+ * @param file Address of FileManager
+ * @param len  written Bytes
+ */
+static void FileManager_markDirty (FileManager* file, uint32_t len) {
+    if (!file->Dirty) {
+        file->Dirty      = 1;
+        file->DirtySince = file->Volume->Driver->GetTimestamp();
+    }
+    file->DirtyBytes         += len;
+    file->Stats.BytesWritten += len;
+}
+
+
 
+/**
+ * @brief Update commit latency stats after Data become durable
+ * 
+ * @param file Address of FileManager
+ */
+static void FileManager_committed (FileManager* file) {
+    uint32_t latency;
+    if (file->Dirty) {
+        latency                        = file->Volume->Driver->GetTimestamp() - file->DirtySince;
+        file->Stats.LastCommitLatency  = latency;
+        file->Stats.TotalCommitLatency += latency;
+        if (latency > file->Stats.MaxCommitLatency) {
+            file->Stats.MaxCommitLatency = latency;
+        }
+        file->Stats.SyncCount++;
+        file->Dirty      = 0;
+        file->DirtyBytes = 0;
+    }
+}
 
 
 
 /**
- * @brief This Function use for Blocking Write (Write until Complete)
+ * @brief end of valid Data which become durable with next Close/Sync, -1 when no checkpoint is needed
+ *        (on framed File it is start of Frame which is still open)
  * 
- * @param file Address of FileManager struct
- * @param addr Address in SdCard File u want to write here
- * @param data Address of Data u want to write in SdCard
- * @param len  Length Of Data u want to Write into SdCard 
- * @return FileManager_Result 
+ * @param file Address of FileManager (File must be open)
  */
-FileManager_Result File_writeBlocking (FileManager* file, int32_t addr, uint8_t* data, int32_t len) {
-    uint32_t  time             = 0;
-    uint16_t tempLen           = 0;
-    uint8_t  overPage          = 0;
-    uint16_t size              = 0;
-    FileManager_Result         fatFsResult;
-    FileManager_CommandHeader  cacheHeader;
-    memset (&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
-    cacheHeader.Addr           = addr;
-    cacheHeader.Len            = len;
-    cacheHeader.Mode           = FileManager_WriteMode;
-    cacheHeader.DataType       = FileManager_Var;
-    if (cacheHeader.Len < 1) {
-        return FileManager_INVALID_PARAMETER;
+static FileManager_Addr FileManager_checkpointEnd (FileManager* file) {
+    if (file->Marker == FILE_MANAGER_NULL || !file->Dirty || file->OtherPath || file->Compress != NULL) {
+        return -1;
     }
-    file->InProcess            = 1;
-    if (fileManagerDriver->IsDetected() != 0) {
-      fatFsResult = fileManagerDriver->Mount(FileManager_ForceMount);
-      if (fileManagerDriver->Open (file, file->Path, FileManager_OpenAlways | FileManager_Write) == FileManager_OK) {
-        size = fileManagerDriver->FileSize(file);
-        
-        if (cacheHeader.Addr != END_OF_FILE) {
-            fatFsResult = fileManagerDriver->Lseek(file, cacheHeader.Addr); 
-        }
-        else {
-            fatFsResult = fileManagerDriver->Lseek(file, size); 
-        }
-        while (cacheHeader.Len > 0  && fatFsResult == FileManager_OK) {
-            overPage       =  cacheHeader.Len > file->Config->MaxSS  ? 1                   : 0;
-            tempLen        =  overPage                               ? file->Config->MaxSS : cacheHeader.Len;
-            time           = fileManagerDriver->GetTimestamp();
-            fatFsResult    =  fileManagerDriver->Write(file, data, tempLen);
-            while(file->PendingByte < tempLen - 1) {
-            }
-            if (time + FILE_MANAGER_TIMEOUT < fileManagerDriver->GetTimestamp()) {
-                return FileManager_TIMEOUT;
-            }
-            cacheHeader.Len -= tempLen;
-            data            += tempLen;
-        }    
-     }
-     fatFsResult = fileManagerDriver->Close(file);
-     file->InProcess = 0;
-   }
-   else {
-        if (file->Callbacks.onNotDetect != NULL) {
-            file->Callbacks.onNotDetect();
-        }
-        fatFsResult = FileManager_DISK_ERR;
-   }
-    return fatFsResult;
+    if (file->Framing && file->FrameOpen && file->CommandHeaderInProcess.Mode == FileManager_WriteMode) {
+        return file->FrameAddr;
+    }
+    return (FileManager_Addr)file->Volume->Driver->FileSize(file);
 }
 
 
 
+/**
+ * @brief CheckpointEnd take end of queued Record after marker has done its command
+ *        (Written and Synced/Closed by SyncPolicy of marker)
+ */
+static void FileManager_checkpointDone (FileManager* file) {
+    if (file->CheckpointId != 0 && file->Marker != FILE_MANAGER_NULL && FileManager_idDone(file->Marker, file->CheckpointId)) {
+        file->CheckpointEnd = file->CheckpointNext;
+        file->CheckpointId  = 0;
+    }
+}
+
 
 
 /**
- * @brief This Function is use For Blocking Read from SdCard (Read Until Complete)
+ * @brief queue checkpoint Record into marker File after Data up to end is durable,
+ *        Record is written when end moved CheckpointSpacing Bytes (or File become shorter),
+ *        if marker File has no space now or still has last Record in its queue it is tried again at next commit
  * 
- * @param file Address of FileManager Struct
+ * @param file Address of FileManager
+ * @param end  durable end of valid Data (FileManager_checkpointEnd)
+ */
+static void FileManager_checkpoint (FileManager* file, FileManager_Addr end) {
+    FileManager_Checkpoint record;
+    FileManager_checkpointDone(file);
+    if (end < 0 || file->CheckpointId != 0 || end == file->CheckpointEnd || (end > file->CheckpointEnd && (FileManager_Size)(end - file->CheckpointEnd) < file->CheckpointSpacing)) {
+        return;
+    }
+    if (Stream_space(&file->Marker->WriteStream) < (int32_t)sizeof(record) || Queue_space(&file->Marker->CommandQueue) == 0) {
+        return;
+    }
+    memset(&record, 0, sizeof(record));
+    record.Magic = FILE_MANAGER_CHECKPOINT_MAGIC;
+    record.Seq   = file->CheckpointSeq + 1;
+    record.End   = end;
+    record.Crc   = FileManagerCRC_calc((uint8_t*)&record, sizeof(record));
+    if (File_write(file->Marker, (FileManager_Addr)(record.Seq % FILE_MANAGER_CHECKPOINT_SLOTS) * sizeof(record), (uint8_t*)&record, sizeof(record), FileManager_Var) == FileManager_OK) {
+        file->CheckpointSeq  = record.Seq;
+        file->CheckpointNext = end;
+        file->CheckpointId   = File_getLastId(file->Marker);
+    }
+}
+
+
+
+#if FILE_MANAGER_USE_ASYNC
+/**
+ * @brief release chunks which are complete (in order), Streams move here,
+ *        failed chunk is reported by onError and submitted again (FILE_MANAGER_ASYNC_RETRIES times)
+ *        so its Data stay in Stream, after last retry Data is dropped and onComplete get FileManager_DISK_ERR,
+ *        ReadStream move only by Bytes which driver read, short read chunk end read command
+ * 
+ * @param file Address of FileManager
+ */
+static void FileManager_asyncRetire (FileManager* file) {
+    FileManager_AsyncOp*      op;
+    FileManager_CommandHeader command;
+    FileManager_Addr          end;
+    int32_t                   len;
+    while (file->AsyncCount > 0 && file->AsyncOps[file->AsyncHead].Done) {
+        op = &file->AsyncOps[file->AsyncHead];
+        if (op->Result != op->Len) {
+            if (file->Callbacks.onError != NULL) {
+                file->Callbacks.onError(file, FileManager_DISK_ERR, op->Addr);
+            }
+            if ((op->Result < 0 || op->Mode == FileManager_WriteMode) && op->Retries < FILE_MANAGER_ASYNC_RETRIES) {
+                op->Retries++;
+                op->Result = 0;
+                op->Done   = 0;
+                if (file->Volume->Driver->Submit(file, op) != FileManager_OK) {
+                    op->Result = -1;                        ///// driver is busy, submit again in next pass
+                    op->Done   = 1;
+                }
+                break;
+            }
+            file->AsyncResult = FileManager_DISK_ERR;
+        }
+        if (op->Mode == FileManager_WriteMode) {
+            Stream_moveReadPos(&file->WriteStream, op->Len);
+            FileManager_markDirty(file, op->Len);
+        }
+        else {
+            len = op->Result > 0 ? op->Result : 0;
+            end = file->ReadCommand.Addr + file->ReadCommand.Len;
+            if (op->Addr + len > end) {
+                len = op->Addr < end ? (int32_t)(end - op->Addr) : 0;   ///// chunk after short chunk, its Data is dropped
+            }
+            Stream_moveWritePos(&file->ReadStream, len);
+            if (len < op->Len && op->Addr < end) {
+                file->ReadCommand.Len            = op->Addr + len - file->ReadCommand.Addr;   ///// short chunk end read command (like sync path)
+                file->CommandHeaderInProcess.Len = 0;
+            }
+        }
+        file->AsyncBytes -= op->Len;
+        file->AsyncHead   = (file->AsyncHead + 1) % FILE_MANAGER_ASYNC_DEPTH;
+        file->AsyncCount--;
+        if (op->Last && op->Mode == FileManager_WriteMode) {
+            memset(&command, 0, sizeof(command));
+            command.Addr = op->Addr + op->Len;              ///// end of written region
+            command.Mode = FileManager_WriteMode;
+            command.Id   = op->Id;
+            if (file->Callbacks.onComplete != NULL) {
+                file->Callbacks.onComplete(file, &command, (FileManager_Result)file->AsyncResult);
+            }
+            file->AsyncResult = FileManager_OK;
+        }
+    }
+}
+
+
+
+/**
+ * @brief wait until all chunks of File are complete
+ * 
+ * @param file Address of FileManager
+ */
+static void FileManager_asyncDrain (FileManager* file) {
+    while (file->AsyncCount > 0) {
+        file->Volume->Driver->Poll(file->Volume, 1);
+        FileManager_asyncRetire(file);
+    }
+}
+#endif
+
+
+
+/**
+ * @brief Close File (Close also commit cached Data)
+ * 
+ * @param file Address of FileManager
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_closeFile (FileManager* file) {
+    FileManager_Result result;
+    FileManager_Addr   end;
+#if FILE_MANAGER_USE_ASYNC
+    FileManager_asyncDrain(file);
+#endif
+    end    = FileManager_checkpointEnd(file);                ///// size is not known after Close
+    result = file->Volume->Driver->Close(file);
+    if (result == FileManager_OK) {
+        if (file->OtherPath && file->Compress != NULL) {
+            file->Compress->CachedStart = -1;               ///// cached Block was from other Path
+        }
+        file->FileStatus = FileManager_FileIsClose;
+        file->OtherPath  = 0;
+        FileManager_committed(file);
+        FileManager_checkpoint(file, end);
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief Sync open File, if driver has no Sync the File is Closed
+ * 
+ * @param file Address of FileManager
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_syncFile (FileManager* file) {
+    FileManager_Result result;
+    FileManager_Addr   end;
+    if (!file->Dirty || file->FileStatus != FileManager_FileIsOpen) {
+        return FileManager_OK;
+    }
+    if (file->Volume->Driver->Sync == NULL) {
+        return FileManager_closeFile(file);
+    }
+    end    = FileManager_checkpointEnd(file);
+    result = file->Volume->Driver->Sync(file);
+    if (result == FileManager_OK) {
+        FileManager_committed(file);
+        FileManager_checkpoint(file, end);
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief Apply SyncPolicy of File at end of one handle pass
+ * 
+ * @param file Address of FileManager
+ * @param done 1 if the command in process is finished
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_commit (FileManager* file, uint8_t done) {
+    if (file->OtherPath) {
+        return done ? FileManager_closeFile(file) : FileManager_OK;
+    }
+    if (file->SyncPolicy == FileManager_SyncOnClose || file->FileStatus != FileManager_FileIsOpen) {
+        return FileManager_closeFile(file);
+    }
+    switch (file->SyncPolicy) {
+        case FileManager_SyncEveryBytes:
+            if (file->DirtyBytes >= file->SyncThreshold) {
+                return FileManager_syncFile(file);
+            }
+            break;
+        case FileManager_SyncEveryTime:
+            if (file->Dirty && file->Volume->Driver->GetTimestamp() - file->DirtySince >= file->SyncThreshold) {
+                return FileManager_syncFile(file);
+            }
+            break;
+        case FileManager_SyncEveryCommand:
+            if (done) {
+                return FileManager_syncFile(file);
+            }
+            break;
+    }
+    return FileManager_OK;
+}
+
+
+
+
+/**
+ * @brief move File to other volume, open File is closed first
+ * 
+ * @param file   Address of FileManager
+ * @param volume Address of FileManager_Volume
+ */
+void File_setVolume (FileManager* file, FileManager_Volume* volume) {
+    if (file->FileStatus == FileManager_FileIsOpen) {
+        FileManager_closeFile(file);
+    }
+    file->Volume = volume;
+}
+
+
+
+/**
+ * @brief set function which Blocking functions call between chunks and while driver make no progress
+ *        (e.g. taskYIELD of RTOS, sched_yield on host), NULL -> Blocking functions only retry
+ * 
+ * @param fn   yield function
+ * @param args passed to fn
+ */
+void FileManager_setYield (FileManager_yieldFn fn, void* args) {
+    yieldFn   = fn;
+    yieldArgs = args;
+}
+
+
+
+/**
+ * @brief set when written Data become durable on SdCard
+ * 
+ * @param file      Address of FileManager
+ * @param policy    FileManager_SyncPolicy
+ * @param threshold Bytes for SyncEveryBytes, ms for SyncEveryTime, otherwise not used
+ */
+void File_setSyncPolicy (FileManager* file, FileManager_SyncPolicy policy, uint32_t threshold) {
+    file->SyncPolicy    = policy;
+    file->SyncThreshold = threshold;
+}
+
+
+
+/**
+ * @brief give File a pending map, File_readBlocking then see Data of queued writes (File_write Var, File_endWrite)
+ *        which is still in WriteStream, range which is all in WriteStream is read without card I/O,
+ *        Const, fill, copy and truncate commands are not in map, until they are done File_readBlocking of Bytes which they change
+ *        (and Bytes after end of File) return FileManager_LOCKED (not for compressed or framed File)
+ * 
+ * @param file Address of FileManager
+ * @param map  Address of pending map, NULL -> disable
+ * @param len  Entries of map, one more than CommandQueue items is always enough
+ *             (File_write return FileManager_NOT_ENOUGH_CORE when map is full)
+ */
+void File_setPendingMap (FileManager* file, FileManager_Pending* map, uint16_t len) {
+    file->Pending      = len > 0 ? map : NULL;
+    file->PendingLen   = len;
+    file->PendingHead  = 0;
+    file->PendingCount = 0;
+}
+
+
+
+/**
+ * @brief last writer win for File_write (Var) at Address, queued write which is not started and is all covered by new write is dropped
+ *        (after new write is queued, refused write drop nothing), queued write which cover new write (and no later command touch range)
+ *        take new Data in WriteStream (no new command, only when onComplete is not set), need pending map (File_setPendingMap)
+ * 
+ * @param file   Address of FileManager
+ * @param enable 1 -> enable, 0 -> disable
+ */
+void File_setDedupe (FileManager* file, uint8_t enable) {
+    file->Dedupe = enable ? 1 : 0;
+}
+
+
+
+/**
+ * @brief drop queued command which is not started, onComplete get FileManager_DENIED for it
+ * 
+ * @param file Address of FileManager
+ * @param id   Id of command (File_getLastId after queue it)
+ * @return FileManager_Result FileManager_INVALID_PARAMETER if command is started or not queued,
+ *         FileManager_NOT_ENOUGH_CORE if FILE_MANAGER_CANCEL_DEPTH commands are waiting for drop
+ */
+FileManager_Result File_cancel (FileManager* file, uint32_t id) {
+    if ((int32_t)(id - file->StartedId) <= 0 || (int32_t)(id - file->LastId) > 0) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    if (FileManager_isCanceled(file, id)) {
+        return FileManager_OK;
+    }
+    if (file->CancelCount == FILE_MANAGER_CANCEL_DEPTH) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    file->Canceled[file->CancelCount++] = id;
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief return Id of last queued command of File
+ */
+uint32_t File_getLastId (FileManager* file) {
+    return file->LastId;
+}
+
+
+
+/**
+ * @brief hold appends (File_write Var at END_OF_FILE) until Bytes to next run boundary of device are in WriteStream,
+ *        appends are cut at run boundaries, so card get whole page-aligned runs in order (sync driver only)
+ * 
+ * @param file    Address of FileManager
+ * @param run     Bytes of run, power of 2 which divide allocation unit of card (e.g. 32KB of 4MB AU), multiple of MaxSS, 0 -> disable
+ * @param phys    device Address of first Byte of File, FILE_MANAGER_ALIGN_DISCOVER -> driver Physical (0 if driver do not know)
+ * @param maxHold max ms which append wait for full run, it is written when WriteStream or CommandQueue is full too
+ */
+void File_setAlignment (FileManager* file, uint32_t run, FileManager_Addr phys, uint32_t maxHold) {
+    file->AlignRun     = run;
+    file->AlignPhys    = phys;
+    file->AlignMaxHold = maxHold;
+    file->AlignPos     = -1;
+    file->AlignHeld    = 0;
+    file->AlignFlush   = 0;
+}
+
+
+
+/**
+ * @brief write checkpoint Records of File into marker File, after a Close/Sync of queued writes made
+ *        spacing Bytes more durable a Record (sequence number, end of valid Data, CRC32C) is queued on marker,
+ *        so File_recover after power loss check only Data after last Record, not whole File
+ * 
+ * @param file    Address of FileManager (append only File, not compressed)
+ * @param marker  small File for Records (keep SyncOnClose or SyncEveryCommand on it), NULL -> disable
+ * @param spacing Bytes between checkpoints, bound of Bytes File_recover read (0 -> Record after every Sync)
+ */
+void File_setCheckpoint (FileManager* file, FileManager* marker, uint32_t spacing) {
+    file->Marker            = marker != file ? marker : FILE_MANAGER_NULL;
+    file->CheckpointSpacing = spacing;
+    file->CheckpointId      = 0;
+}
+
+
+
+/**
+ * @brief return end of Data which last checkpoint Record cover, Record count only after marker has written it
+ *        (after File_recover: end of newest Record, or end of verified Frames of framed File)
+ */
+FileManager_Addr File_getCheckpoint (FileManager* file) {
+    FileManager_checkpointDone(file);
+    return file->CheckpointEnd;
+}
+
+
+
+/**
+ * @brief NonBlocking Sync, all commands queued before this one become durable when it run
+ * 
+ * @param file Address of FileManager
+ * @return FileManager_Result 
+ */
+FileManager_Result File_flush (FileManager* file) {
+    FileManager_CommandHeader cacheHeader;
+    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
+    cacheHeader.Addr           = END_OF_FILE;
+    cacheHeader.Len            = 1;
+    cacheHeader.DataType       = FileManager_Var;
+    cacheHeader.Mode           = FileManager_SyncMode;
+    return FileManager_enqueue(file, &cacheHeader);
+}
+
+
+
+/**
+ * @brief set device Address of next append from Size of open File
+ */
+static void FileManager_alignAt (FileManager* file, FileManager_Addr size) {
+    FileManager_Addr phys = file->AlignPhys;
+    if (file->AlignRun == 0) {
+        return;
+    }
+    if (phys < 0) {
+        phys = file->Volume->Driver->Physical != NULL ? file->Volume->Driver->Physical(file) : -1;
+        if (phys >= 0 && size > 0) {
+            file->AlignPhys = phys;                         ///// Clusters of File are known now
+        }
+        else if (phys < 0 && size > 0 && file->Volume->Driver->Physical != NULL) {
+            file->AlignPos = -1;                            ///// fragmented File, appends are not held or cut
+            return;
+        }
+    }
+    file->AlignPos = (phys > 0 ? phys : 0) + size;
+}
+
+
+
+/**
+ * @brief check append in process must wait for more Bytes (run of device is not full and maxHold is not passed)
+ */
+static uint8_t FileManager_alignHold (FileManager* file) {
+    FileManager_CommandHeader* command = &file->CommandHeaderInProcess;
+    FileManager_Timestamp      now;
+    if (file->AlignRun == 0 || file->AlignPos < 0 || command->Mode != FileManager_WriteMode || command->DataType != FileManager_Var ||
+        command->Addr != END_OF_FILE || file->Compress != NULL || file->Framing) {
+        return 0;
+    }
+    if (file->AlignFlush && file->AlignPos % file->AlignRun != 0) {
+        return 0;                                           ///// Bytes of timed out run are written until next boundary
+    }
+    file->AlignFlush = 0;
+    if (Stream_available(&file->WriteStream) >= (int32_t)(file->AlignRun - (uint32_t)(file->AlignPos % file->AlignRun)) ||
+        Stream_space(&file->WriteStream) == 0 || Queue_space(&file->CommandQueue) == 0) {
+        file->AlignHeld = 0;
+        return 0;
+    }
+    now = file->Volume->Driver->GetTimestamp();
+    if (!file->AlignHeld) {
+        file->AlignHeld  = 1;
+        file->AlignSince = now;
+    }
+    else if (now - file->AlignSince >= file->AlignMaxHold) {
+        file->AlignHeld  = 0;
+        file->AlignFlush = 1;
+        file->Stats.HoldTimeouts++;
+        return 0;
+    }
+    return 1;
+}
+
+
+
+/**
+ * @brief count time of driver Write which start at start
+ */
+static void FileManager_writeTime (FileManager* file, FileManager_Timestamp start) {
+    uint32_t time = file->Volume->Driver->GetTimestamp() - start;
+    if (time > file->Stats.MaxWriteTime) {
+        file->Stats.MaxWriteTime = time;
+    }
+    if (time >= FILE_MANAGER_STALL_TIME) {
+        file->Stats.Stalls++;
+    }
+}
+
+
+
+/**
+ * @brief Blocking get Size of File
+ * 
+ * @param file Address of FileManager
+ * @return FileManager_Size Size of File (0 if File can not open)
+ */
+FileManager_Size File_getSize (FileManager* file) {
+    FileManager_Size size = 0;
+    file->InProcess = 1;
+    if (FileManager_detect(file->Volume) != 0) {
+        FileManager_mount(file->Volume);
+        if (file->FileStatus == FileManager_FileIsOpen) {
+            FileManager_closeFile(file);
+        }
+        if (file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Read) == FileManager_OK) {
+            size = file->Volume->Driver->FileSize(file);
+            file->Volume->Driver->Close(file);
+        }
+    }
+    file->InProcess = 0;
+    return size;
+}
+
+
+
+/**
+ * @brief return Stats of File
+ * 
+ * @param file Address of FileManager
+ * @return const FileManager_Stats* 
+ */
+const FileManager_Stats* File_getStats (FileManager* file) {
+    return &file->Stats;
+}
+
+
+
+void File_resetStats (FileManager* file) {
+    memset(&file->Stats, 0, sizeof(file->Stats));
+}
+
+
+
+
+
+
+
+
+/**
+ * @brief Blocking transfer of len Bytes at current position of open File, driver may transfer only part of chunk,
+ *        rest is retried and yield function is called between chunks,
+ *        FileManager_TIMEOUT when driver make no progress for FILE_MANAGER_TIMEOUT ms
+ * 
+ * @param file  Address of FileManager
+ * @param data  Address of Data
+ * @param len   Length of Data
+ * @param write 1 -> Write, 0 -> Read
+ * @param done  Bytes transferred (Read stop at end of File)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_transfer (FileManager* file, uint8_t* data, int32_t len, uint8_t write, int32_t* done) {
+    FileManager_Result result = FileManager_OK;
+    uint32_t           time   = file->Volume->Driver->GetTimestamp();
+    int32_t            tempLen;
+    *done = 0;
+    while (*done < len && result == FileManager_OK) {
+        tempLen           = len - *done > file->Config->MaxSS ? file->Config->MaxSS : len - *done;
+        file->PendingByte = 0;
+        if (write) {
+            result = file->Volume->Driver->Write(file, data + *done, tempLen);
+        }
+        else {
+            result = file->Volume->Driver->Read(file, data + *done, tempLen);
+        }
+        if (result != FileManager_OK) {
+            break;
+        }
+        if (file->PendingByte > 0) {
+            *done += file->PendingByte;
+            time   = file->Volume->Driver->GetTimestamp();
+        }
+        else if (!write) {
+            break;                                          ///// end of File
+        }
+        else if ((uint32_t)(file->Volume->Driver->GetTimestamp() - time) >= FILE_MANAGER_TIMEOUT) {
+            result = FileManager_TIMEOUT;
+        }
+        if (yieldFn != NULL) {
+            yieldFn(yieldArgs);
+        }
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief Blocking write of elements with swapped Bytes, swapBuffer is filled and written chunk by chunk
+ */
+static FileManager_Result FileManager_transferSwap (FileManager* file, const uint8_t* data, int32_t len, uint8_t size, int32_t* done) {
+    FileManager_Result result = FileManager_OK;
+    int32_t            tempLen;
+    int32_t            tempDone;
+    *done = 0;
+    while (*done < len && result == FileManager_OK) {
+        tempLen = len - *done > (int32_t)sizeof(swapBuffer) ? (int32_t)sizeof(swapBuffer) : len - *done;
+        FileManagerSwap_copy((uint8_t*)swapBuffer, data + *done, tempLen / size, size);
+        result  = FileManager_transfer(file, (uint8_t*)swapBuffer, tempLen, 1, &tempDone);
+        *done  += tempDone;
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief Blocking Write, swap > 1 write elements of swap Bytes in other Byte order
+ */
+static FileManager_Result FileManager_writeBlocking (FileManager* file, FileManager_Addr addr, const uint8_t* data, int32_t len, uint8_t swap) {
+    int32_t            done        = 0;
+    FileManager_Result fatFsResult;
+    FileManager_Result closeResult;
+    if (len < 1) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    file->InProcess            = 1;
+    if (FileManager_detect(file->Volume) != 0) {
+        fatFsResult = FileManager_mount(file->Volume);
+        if (file->FileStatus == FileManager_FileIsOpen) {
+            FileManager_closeFile(file);
+        }
+        fatFsResult = file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Write);
+        if (fatFsResult == FileManager_OK) {
+            if (addr == END_OF_FILE) {
+                addr = file->Volume->Driver->FileSize(file);
+            }
+            fatFsResult = file->Volume->Driver->Lseek(file, addr);
+            if (fatFsResult == FileManager_OK) {
+                fatFsResult = swap > 1 ? FileManager_transferSwap(file, data, len, swap, &done) : FileManager_transfer(file, (uint8_t*)data, len, 1, &done);
+            }
+            closeResult = file->Volume->Driver->Close(file);
+            if (fatFsResult == FileManager_OK) {
+                fatFsResult = closeResult;
+            }
+            file->Stats.BytesWritten += done;
+        }
+    }
+    else {
+        if (file->Callbacks.onNotDetect != NULL) {
+            file->Callbacks.onNotDetect();
+        }
+        fatFsResult = FileManager_DISK_ERR;
+    }
+    file->InProcess = 0;
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief This Function use for Blocking Write (Write until Complete)
+ * 
+ * @param file Address of FileManager struct
+ * @param addr Address in SdCard File u want to write here
+ * @param data Address of Data u want to write in SdCard
+ * @param len  Length Of Data u want to Write into SdCard 
+ * @return FileManager_Result 
+ */
+FileManager_Result File_writeBlocking (FileManager* file, FileManager_Addr addr, uint8_t* data, int32_t len) {
+    return FileManager_writeBlocking(file, addr, data, len, 1);
+}
+
+
+
+
+
+/**
+ * @brief This Function is use For Blocking Read from SdCard (Read Until Complete)
+ *        with pending map (File_setPendingMap) Bytes of queued writes replace card Data
+ * 
+ * @param file Address of FileManager Struct
  * @param addr SdCard FileAddress u want to Read From that
  * @param data Address of Data u want to Read in SdCard
  * @param len  Length Of Data u want to Read from SdCard
+ * @return FileManager_Result FileManager_EOF if File end before len Bytes (Bytes before end are in data),
+ *         FileManager_LOCKED with pending map when queued Fill/Const/Copy/Truncate change these Bytes (read again after it is done)
+ */
+FileManager_Result File_readBlocking (FileManager* file, FileManager_Addr addr, uint8_t* data, int32_t len) {
+    int32_t            done        = 0;
+    FileManager_Result fatFSResult = FileManager_OK;
+    FileManager_Addr   size;
+    uint8_t            pending;
+    if (len < 1) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    pending = file->Pending != NULL && file->Compress == NULL && !file->Framing;
+    if (pending && !FileManager_pendingBarrier(file, addr, len, -1) && FileManager_pendingCovers(file, addr, len, -1)) {
+        FileManager_pendingWalk(file, addr, data, len, -1);      ///// all Bytes are in WriteStream, no card I/O
+        return FileManager_OK;
+    }
+    file->InProcess = 1;
+    if (FileManager_detect(file->Volume) == 1) {
+        FileManager_mount(file->Volume);
+        if (file->FileStatus == FileManager_FileIsOpen) {
+            FileManager_closeFile(file);
+        }
+        if (file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Read) == FileManager_OK) {
+            size = pending ? (FileManager_Addr)file->Volume->Driver->FileSize(file) : -1;
+            if (pending && FileManager_pendingBarrier(file, addr, len, size)) {
+                fatFSResult = FileManager_LOCKED;           ///// queued Fill/Const/Copy/Truncate change these Bytes, read after drain
+            }
+            else if (!pending || !FileManager_pendingCovers(file, addr, len, size)) {
+                fatFSResult = file->Volume->Driver->Lseek(file, addr);
+                if (fatFSResult == FileManager_OK) {
+                    fatFSResult = FileManager_transfer(file, data, len, 0, &done);
+                }
+            }
+            if (pending && fatFSResult == FileManager_OK) {
+                FileManager_pendingWalk(file, addr, data, len, size);   ///// newer Bytes of queued writes
+            }
+            if (fatFSResult == FileManager_OK && done < len && !(pending && FileManager_pendingCovers(file, addr + done, len - done, size))) {
+                fatFSResult = FileManager_EOF;
+            }
+            file->Volume->Driver->Close(file);
+        }
+        else {
+            fatFSResult = FileManager_INT_ERR;
+        }
+    }
+    else {
+        if (file->Callbacks.onNotDetect != NULL) {
+            file->Callbacks.onNotDetect();
+        }
+       fatFSResult = FileManager_DISK_ERR;
+    }
+    file->InProcess = 0;
+    return fatFSResult;
+}
+
+
+
+/**
+ * @brief Load pattern into the static fill buffer (only when pattern changes)
+ * 
+ * @param pattern byte value to fill
+ */
+static void FileManager_preparePattern (uint8_t pattern) {
+    if (fillBufferPattern != pattern) {
+        memset(fillBuffer, pattern, sizeof(fillBuffer));
+        fillBufferPattern = pattern;
+    }
+}
+
+
+
+/**
+ * @brief return length of next fill chunk, first chunk is cut so next chunks start on sector boundary
+ * 
+ * @param file Address of FileManager
+ * @param pos  Current position in File
+ * @param len  Remaining length of fill
+ * @return int16_t 
+ */
+static int16_t FileManager_fillChunkLen (FileManager* file, FileManager_Addr pos, int32_t len) {
+    int16_t sector = file->Config->MaxSS < FILE_MANAGER_FILL_BUFFER_SIZE ? file->Config->MaxSS : FILE_MANAGER_FILL_BUFFER_SIZE;
+    int16_t chunk  = sector - (pos % sector);
+    return len < chunk ? (int16_t)len : chunk;
+}
+
+
+
+/**
+ * @brief This Function use for Blocking Truncate File at addr (File become addr Bytes)
+ * 
+ * @param file Address of FileManager struct
+ * @param addr new size of File
+ * @return FileManager_Result 
+ */
+FileManager_Result File_truncate (FileManager* file, FileManager_Addr addr) {
+    FileManager_Result fatFsResult;
+    if (addr < 0) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    if (file->Volume->Driver->Truncate == NULL) {
+        return FileManager_NOT_ENABLED;
+    }
+    file->InProcess = 1;
+    if (FileManager_detect(file->Volume) != 0) {
+        fatFsResult = FileManager_mount(file->Volume);
+        if (file->FileStatus == FileManager_FileIsOpen) {
+            FileManager_closeFile(file);
+        }
+        fatFsResult = file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Write);
+        if (fatFsResult == FileManager_OK) {
+            fatFsResult = file->Volume->Driver->Lseek(file, addr);
+            if (fatFsResult == FileManager_OK) {
+                fatFsResult = file->Volume->Driver->Truncate(file);
+            }
+            file->Volume->Driver->Close(file);
+        }
+    }
+    else {
+        if (file->Callbacks.onNotDetect != NULL) {
+            file->Callbacks.onNotDetect();
+        }
+        fatFsResult = FileManager_DISK_ERR;
+    }
+    file->InProcess = 0;
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief NonBlocking Truncate, File become addr Bytes after commands queued before it
+ * 
+ * @param file Address of FileManager struct
+ * @param addr new size of File
+ * @return FileManager_Result FileManager_NOT_ENABLED if driver has no Truncate or File is compressed
+ */
+FileManager_Result File_queueTruncate (FileManager* file, FileManager_Addr addr) {
+    FileManager_CommandHeader cacheHeader;
+    if (addr < 0) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    if (file->Volume->Driver->Truncate == NULL || file->Compress != NULL) {
+        return FileManager_NOT_ENABLED;
+    }
+    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
+    cacheHeader.Addr           = addr;
+    cacheHeader.Len            = 1;
+    cacheHeader.DataType       = FileManager_Var;
+    cacheHeader.Mode           = FileManager_TruncateMode;
+    if (FileManager_enqueue(file, &cacheHeader) != FileManager_OK) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    FileManager_barrierAdd(file, addr, -1);
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief read one Frame at pos and verify its CRC32C
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @param pos  Address of Frame
+ * @param size size of File
+ * @return Address after Frame, -1 if Frame is torn or corrupt
+ */
+static FileManager_Addr FileManager_recoverFrame (FileManager* file, FileManager_Addr pos, FileManager_Addr size) {
+    FileManager_FrameHeader header;
+    uint8_t                 buffer[FILE_MANAGER_RECOVER_BUFFER_SIZE];
+    uint32_t                crc    = FILE_MANAGER_CRC_INIT;
+    uint32_t                stored = 0;
+    int32_t                 done;
+    int32_t                 remain;
+    int32_t                 len;
+
+    if (size - pos < (FileManager_Addr)(sizeof(header) + sizeof(stored)) || file->Volume->Driver->Lseek(file, pos) != FileManager_OK ||
+        FileManager_transfer(file, (uint8_t*)&header, sizeof(header), 0, &done) != FileManager_OK || done < (int32_t)sizeof(header) ||
+        header.Magic != FILE_MANAGER_FRAME_MAGIC || header.Len < 0 || size - pos - (FileManager_Addr)(sizeof(header) + sizeof(stored)) < header.Len) {
+        return -1;
+    }
+    for (remain = header.Len; remain > 0; remain -= len) {
+        len = remain > (int32_t)sizeof(buffer) ? (int32_t)sizeof(buffer) : remain;
+        if (FileManager_transfer(file, buffer, len, 0, &done) != FileManager_OK || done < len) {
+            return -1;
+        }
+        crc = FileManagerCRC_update(crc, buffer, len);
+    }
+    if (FileManager_transfer(file, (uint8_t*)&stored, sizeof(stored), 0, &done) != FileManager_OK || done < (int32_t)sizeof(stored) ||
+        stored != FileManagerCRC_final(crc)) {
+        return -1;
+    }
+    return pos + sizeof(header) + header.Len + sizeof(stored);
+}
+
+
+
+/**
+ * @brief Blocking recovery after power loss (call it before queue commands of File),
+ *        newest valid Record of marker give end of durable Data, framed File is verified Frame by Frame after it
+ *        and torn tail after valid Frames is Truncated, so work depend on checkpoint spacing, not size of File.
+ *        Other File is not Truncated (Bytes after Record has no CRC), File_getCheckpoint give Record end to check them.
+ *        Next Records continue sequence of marker
+ * 
+ * @param file   Address of FileManager
+ * @param marker marker File of File_setCheckpoint
+ * @param end    valid size of File after recovery (NULL -> not needed)
+ * @return FileManager_Result FileManager_NOT_ENABLED if driver has no Truncate
+ */
+FileManager_Result File_recover (FileManager* file, FileManager* marker, FileManager_Addr* end) {
+    FileManager_Checkpoint records[FILE_MANAGER_CHECKPOINT_SLOTS];
+    FileManager_Checkpoint record;
+    FileManager_Result     fatFsResult;
+    FileManager_Addr       size;
+    FileManager_Addr       valid = 0;
+    FileManager_Addr       checkpoint;
+    FileManager_Addr       next;
+    uint32_t               crc;
+    uint8_t                found = 0;
+    uint8_t                i;
+
+    memset(records, 0, sizeof(records));
+    fatFsResult = File_readBlocking(marker, 0, (uint8_t*)records, sizeof(records));
+    if (fatFsResult != FileManager_OK && fatFsResult != FileManager_EOF) {          ///// not all slots are written yet
+        return fatFsResult;
+    }
+    for (i = 0; i < FILE_MANAGER_CHECKPOINT_SLOTS; i++) {
+        record     = records[i];
+        crc        = record.Crc;
+        record.Crc = 0;
+        if (record.Magic == FILE_MANAGER_CHECKPOINT_MAGIC && crc == FileManagerCRC_calc((uint8_t*)&record, sizeof(record)) &&
+            (!found || (int32_t)(record.Seq - file->CheckpointSeq) > 0)) {
+            file->CheckpointSeq = record.Seq;
+            valid               = record.End;
+            found               = 1;
+        }
+    }
+    file->InProcess = 1;
+    if (FileManager_detect(file->Volume) != 0) {
+        FileManager_mount(file->Volume);
+        if (file->FileStatus == FileManager_FileIsOpen) {
+            FileManager_closeFile(file);
+        }
+        fatFsResult = file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Read | FileManager_Write);
+        if (fatFsResult == FileManager_OK) {
+            size = (FileManager_Addr)file->Volume->Driver->FileSize(file);
+            if (file->Framing) {
+                while (valid < size && (next = FileManager_recoverFrame(file, valid, size)) > 0) {
+                    valid = next;
+                }
+                checkpoint = valid;
+            }
+            else {
+                checkpoint = found && valid < size ? valid : size;
+                valid      = size;                          ///// Bytes after Record can not be verified, Size of File only move by Sync/Close so they are kept
+            }
+            if (valid < size) {
+                fatFsResult = file->Volume->Driver->Truncate == NULL ? FileManager_NOT_ENABLED : file->Volume->Driver->Lseek(file, valid);
+                if (fatFsResult == FileManager_OK) {
+                    fatFsResult = file->Volume->Driver->Truncate(file);
+                }
+            }
+            else {
+                valid = size;
+            }
+            file->Volume->Driver->Close(file);
+            file->CheckpointEnd = checkpoint;
+            file->CheckpointId  = 0;
+            if (end != NULL) {
+                *end = valid;
+            }
+        }
+    }
+    else {
+        if (file->Callbacks.onNotDetect != NULL) {
+            file->Callbacks.onNotDetect();
+        }
+        fatFsResult = FileManager_DISK_ERR;
+    }
+    file->InProcess = 0;
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief This Function use for Blocking Erase all of File (File Size become zero)
+ * 
+ * @param file Address of FileManager struct
+ * @return FileManager_Result 
+ */
+FileManager_Result File_erase (FileManager* file) {
+    return File_truncate(file, 0);
+}
+
+
+
+/**
+ * @brief This Function use for Blocking Fill a region of File with one pattern
+ *        data written in sector size chunks from static fill buffer, so no big stack buffer need
+ * 
+ * @param file    Address of FileManager struct
+ * @param addr    Address in File (or END_OF_FILE)
+ * @param len     Length of region
+ * @param pattern byte value
+ * @return FileManager_Result 
+ */
+FileManager_Result File_fillBlocking (FileManager* file, FileManager_Addr addr, int32_t len, uint8_t pattern) {
+    int32_t            done = 0;
+    int16_t            tempLen;
+    FileManager_Result fatFsResult;
+    if (len < 1) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    file->InProcess = 1;
+    if (FileManager_detect(file->Volume) != 0) {
+        fatFsResult = FileManager_mount(file->Volume);
+        if (file->FileStatus == FileManager_FileIsOpen) {
+            FileManager_closeFile(file);
+        }
+        fatFsResult = file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Write);
+        if (fatFsResult == FileManager_OK) {
+            if (addr == END_OF_FILE) {
+                addr = file->Volume->Driver->FileSize(file);
+            }
+            fatFsResult = file->Volume->Driver->Lseek(file, addr);
+            FileManager_preparePattern(pattern);
+            while (len > 0 && fatFsResult == FileManager_OK) {
+                tempLen     = FileManager_fillChunkLen(file, addr, len);
+                fatFsResult = FileManager_transfer(file, fillBuffer, tempLen, 1, &done);
+                addr += done;
+                len  -= done;
+                file->Stats.BytesWritten += done;
+            }
+            file->Volume->Driver->Close(file);
+        }
+    }
+    else {
+        if (file->Callbacks.onNotDetect != NULL) {
+            file->Callbacks.onNotDetect();
+        }
+        fatFsResult = FileManager_DISK_ERR;
+    }
+    file->InProcess = 0;
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief NonBlocking Fill a region of File with one pattern, FileManager_handle write it sector by sector
+ * 
+ * @param file    Address of FileManager struct
+ * @param addr    Address in File (or END_OF_FILE)
+ * @param len     Length of region
+ * @param pattern byte value
+ * @return FileManager_Result FileManager_NOT_ENABLED on compressed File (raw pattern would break Blocks)
+ */
+FileManager_Result File_fill (FileManager* file, FileManager_Addr addr, int32_t len, uint8_t pattern) {
+    FileManager_CommandHeader cacheHeader;
+    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
+    cacheHeader.Addr           = addr;
+    cacheHeader.Len            = len;
+    cacheHeader.DataType       = FileManager_Const;
+    cacheHeader.Mode           = FileManager_FillMode;
+
+    if (cacheHeader.Len < 1) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    if (file->Compress != NULL) {
+        return FileManager_NOT_ENABLED;
+    }
+    if (Stream_space(&file->WriteStream) < (int32_t)sizeof(pattern) || FileManager_enqueue(file, &cacheHeader) != FileManager_OK) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    FileManager_streamWrite(file, &pattern, sizeof(pattern));
+    FileManager_barrierAdd(file, addr, len);
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief return length of next copy block, first block is cut so next blocks of dst start on sector boundary
+ */
+static int32_t FileManager_copyBlockLen (FileManager* dst, FileManager_Addr pos, int32_t len) {
+    int32_t sector = dst->Config->MaxSS < FILE_MANAGER_COPY_BUFFER_SIZE ? dst->Config->MaxSS : FILE_MANAGER_COPY_BUFFER_SIZE;
+    int32_t block  = FILE_MANAGER_COPY_BUFFER_SIZE - (int32_t)(pos % sector);
+    return len < block ? len : block;
+}
+
+
+
+/**
+ * @brief start read/write of one copy block, on async driver block is submitted and run while other block is handled,
+ *        otherwise it is done here with one driver Read/Write of whole block, only rest of partial transfer
+ *        go through Blocking transfer (op->Result transferred Bytes, negative -> error)
+ */
+static void FileManager_copyIssue (FileManager* file, FileManager_AsyncOp* op) {
+    FileManager_Result result;
+    int32_t            done = 0;
+    int32_t            rest = 0;
+#if FILE_MANAGER_USE_ASYNC
+    if (file->Volume->Driver->Submit != NULL) {
+        op->Result = 0;
+        op->Done   = 0;
+        op->Last   = 1;
+        if (file->Volume->Driver->Submit(file, op) == FileManager_OK) {
+            file->Volume->Driver->Poll(file->Volume, 0);    ///// start it now
+            return;
+        }
+    }
+#endif
+    result = file->Volume->Driver->Lseek(file, op->Addr);
+    if (result == FileManager_OK) {
+        file->PendingByte = 0;
+        if (op->Mode == FileManager_WriteMode) {
+            result = file->Volume->Driver->Write(file, op->Data, op->Len);   ///// multi sector transfer, block is aligned
+        }
+        else {
+            result = file->Volume->Driver->Read(file, op->Data, op->Len);
+        }
+        done = (int32_t)file->PendingByte;
+    }
+    if (result == FileManager_OK && done < op->Len && (op->Mode == FileManager_WriteMode || done > 0)) {
+        result = FileManager_transfer(file, (uint8_t*)op->Data + done, op->Len - done, op->Mode == FileManager_WriteMode, &rest);
+        done  += rest;                                      ///// driver transferred only part of block, Read of nothing is end of File
+    }
+    op->Result = result == FileManager_OK ? done : -1;
+    op->Done   = 1;
+}
+
+
+
+/**
+ * @brief wait until copy block is complete
+ */
+static void FileManager_copyWait (FileManager* file, FileManager_AsyncOp* op) {
+#if FILE_MANAGER_USE_ASYNC
+    while (!op->Done) {
+        file->Volume->Driver->Poll(file->Volume, 1);
+    }
+#else
+    (void)file;
+    (void)op;
+#endif
+}
+
+
+
+/**
+ * @brief copy up to blocks buffers from src to dst (both open), next block is read while current block is written
+ *        when src or dst has async driver (two sync drivers run one after other), copy stop at end of src
+ * 
+ * @param src     Address of source FileManager
+ * @param dst     Address of destination FileManager
+ * @param srcAddr Address in src
+ * @param dstAddr Address in dst
+ * @param len     max Bytes to copy
+ * @param blocks  max blocks to copy
+ * @param copied  Bytes written into dst
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_copyBlocks (FileManager* src, FileManager* dst, FileManager_Addr srcAddr, FileManager_Addr dstAddr, int32_t len, int32_t blocks, int32_t* copied) {
+    FileManager_AsyncOp readOp;
+    FileManager_AsyncOp writeOp;
+    FileManager_Result  result = FileManager_OK;
+    uint8_t             buffer = 0;
+    uint8_t             more;
+
+    *copied      = 0;
+    readOp.Mode  = FileManager_ReadMode;
+    readOp.Data  = copyBuffer[buffer];
+    readOp.Addr  = srcAddr;
+    readOp.Len   = FileManager_copyBlockLen(dst, dstAddr, len);
+    writeOp.Mode = FileManager_WriteMode;
+    FileManager_copyIssue(src, &readOp);
+    FileManager_copyWait(src, &readOp);
+    while (readOp.Result > 0) {
+        writeOp.Data = readOp.Data;
+        writeOp.Addr = dstAddr + *copied;
+        writeOp.Len  = readOp.Result;
+        more         = readOp.Result == readOp.Len && *copied + writeOp.Len < len && --blocks > 0;
+        if (more) {
+            buffer      ^= 1;
+            readOp.Data  = copyBuffer[buffer];
+            readOp.Addr  = srcAddr + *copied + writeOp.Len;
+            readOp.Len   = FileManager_copyBlockLen(dst, writeOp.Addr + writeOp.Len, len - *copied - writeOp.Len);
+        }
+        if (dst->Volume->Driver->Submit != NULL) {         ///// issue async side first, so sync side overlap it
+            FileManager_copyIssue(dst, &writeOp);
+            if (more) {
+                FileManager_copyIssue(src, &readOp);
+            }
+        }
+        else {
+            if (more) {
+                FileManager_copyIssue(src, &readOp);
+            }
+            FileManager_copyIssue(dst, &writeOp);
+        }
+        FileManager_copyWait(dst, &writeOp);
+        if (more) {
+            FileManager_copyWait(src, &readOp);
+        }
+        if (writeOp.Result != writeOp.Len) {
+            return FileManager_DISK_ERR;
+        }
+        *copied += writeOp.Len;
+        if (!more) {
+            break;
+        }
+    }
+    if (readOp.Result < 0) {
+        result = FileManager_DISK_ERR;
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief copy FILE_MANAGER_COPY_BLOCKS blocks of copy command in process (called from FileManager_handle, dst is open)
+ * 
+ * @param file Address of destination FileManager
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_copyPass (FileManager* file) {
+    FileManager*       src    = file->CopySrc;
+    FileManager_Result result = FileManager_OK;
+    FileManager_Addr   pos    = file->CommandHeaderInProcess.Addr != END_OF_FILE ? file->CommandHeaderInProcess.Addr : (FileManager_Addr)file->Volume->Driver->FileSize(file);
+    int32_t            copied = 0;
+
+    if (src != file && src->FileStatus != FileManager_FileIsOpen) {
+        FileManager_mount(src->Volume);
+        result = src->Volume->Driver->Open(src, src->Path, FileManager_OpenAlways | FileManager_Write | FileManager_Read);
+        if (result == FileManager_OK) {
+            src->FileStatus = FileManager_FileIsOpen;
+        }
+    }
+#if FILE_MANAGER_USE_ASYNC
+    if (src != file && src->AsyncCount > 0) {
+        FileManager_asyncDrain(src);                        ///// chunks of src in flight must be on SdCard before copy
+    }
+#endif
+    if (result == FileManager_OK) {
+        result = FileManager_copyBlocks(src, file, file->CopyAddr, pos, file->CommandHeaderInProcess.Len, FILE_MANAGER_COPY_BLOCKS, &copied);
+    }
+    if (copied > 0) {
+        FileManager_markDirty(file, copied);
+    }
+    file->CopyAddr                    += copied;
+    file->CommandHeaderInProcess.Len  -= copied;
+    if (file->CommandHeaderInProcess.Addr != END_OF_FILE) {
+        file->CommandHeaderInProcess.Addr += copied;
+    }
+    if (result != FileManager_OK || copied == 0) {
+        file->CommandHeaderInProcess.Len = 0;               ///// end of src or error, drop rest of command
+    }
+    if (file->CommandHeaderInProcess.Len < 1 && src != file && src->FileStatus == FileManager_FileIsOpen) {
+        FileManager_closeFile(src);
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief NonBlocking copy of len Bytes from src into dst, FileManager_handle copy FILE_MANAGER_COPY_BLOCKS blocks in each pass
+ *        (command is queued on dst, copy stop at end of src), each block is one driver Read and one driver Write,
+ *        read of next block overlap write of current block only on async driver
+ * 
+ * @param src     Address of source FileManager
+ * @param dst     Address of destination FileManager
+ * @param srcAddr Address in src
+ * @param dstAddr Address in dst (or END_OF_FILE)
+ * @param len     Length of copy
+ * @return FileManager_Result FileManager_NOT_ENABLED if src or dst is compressed (copy move raw Bytes)
+ */
+FileManager_Result File_copy (FileManager* src, FileManager* dst, FileManager_Addr srcAddr, FileManager_Addr dstAddr, int32_t len) {
+    FileManager_CommandHeader cacheHeader;
+    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
+    cacheHeader.Addr           = dstAddr;
+    cacheHeader.Len            = len;
+    cacheHeader.DataType       = FileManager_Var;
+    cacheHeader.Mode           = FileManager_CopyMode;
+
+    if (cacheHeader.Len < 1 || srcAddr < 0) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    if (src->Compress != NULL || dst->Compress != NULL) {
+        return FileManager_NOT_ENABLED;
+    }
+    if (Stream_space(&dst->WriteStream) < (int32_t)(sizeof(src) + sizeof(srcAddr)) || FileManager_enqueue(dst, &cacheHeader) != FileManager_OK) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    FileManager_streamWrite(dst, (uint8_t*)&src, sizeof(src));
+    FileManager_streamWrite(dst, (uint8_t*)&srcAddr, sizeof(srcAddr));
+    FileManager_barrierAdd(dst, dstAddr, len);
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief Blocking copy of len Bytes from src into dst through two buffers with multi sector transfers
+ *        (one driver Read and one driver Write for each block), only on async driver next block is read
+ *        while current block is written, with sync drivers they run one after other (copy stop at end of src)
+ * 
+ * @param src     Address of source FileManager
+ * @param dst     Address of destination FileManager
+ * @param srcAddr Address in src
+ * @param dstAddr Address in dst (or END_OF_FILE)
+ * @param len     Length of copy
+ * @return FileManager_Result 
+ */
+FileManager_Result File_copyBlocking (FileManager* src, FileManager* dst, FileManager_Addr srcAddr, FileManager_Addr dstAddr, int32_t len) {
+    FileManager_Result fatFsResult;
+    int32_t            copied = 0;
+    if (len < 1 || srcAddr < 0) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    src->InProcess = 1;
+    dst->InProcess = 1;
+    if (FileManager_detect(src->Volume) != 0 && FileManager_detect(dst->Volume) != 0) {
+        FileManager_mount(src->Volume);
+        FileManager_mount(dst->Volume);
+        if (src->FileStatus == FileManager_FileIsOpen) {
+            FileManager_closeFile(src);
+        }
+        if (dst->FileStatus == FileManager_FileIsOpen) {
+            FileManager_closeFile(dst);
+        }
+        fatFsResult = dst->Volume->Driver->Open(dst, dst->Path, FileManager_OpenAlways | FileManager_Write | FileManager_Read);
+        if (fatFsResult == FileManager_OK) {
+            if (src != dst) {
+                fatFsResult = src->Volume->Driver->Open(src, src->Path, FileManager_OpenAlways | FileManager_Read);
+            }
+            if (fatFsResult == FileManager_OK) {
+                if (dstAddr == END_OF_FILE) {
+                    dstAddr = dst->Volume->Driver->FileSize(dst);
+                }
+                fatFsResult = FileManager_copyBlocks(src, dst, srcAddr, dstAddr, len, INT32_MAX, &copied);
+                if (src != dst) {
+                    src->Volume->Driver->Close(src);
+                }
+            }
+            if (dst->Volume->Driver->Close(dst) != FileManager_OK && fatFsResult == FileManager_OK) {
+                fatFsResult = FileManager_DISK_ERR;
+            }
+            dst->Stats.BytesWritten += copied;
+        }
+    }
+    else {
+        if (dst->Callbacks.onNotDetect != NULL) {
+            dst->Callbacks.onNotDetect();
+        }
+        fatFsResult = FileManager_DISK_ERR;
+    }
+    src->InProcess = 0;
+    dst->InProcess = 0;
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief Enable Compression of File, Data of File become independent compressed Blocks
+ *        (Blocking, it scan Block Headers of existing File to rebuild Index)
+ *        write commands must append (File_write, File_writeArray and File_endWrite refuse other Address), read and Logger read commands use Logical Address,
+ *        File_fill, File_copy and File_queueTruncate are refused, Blocking Write/Read see raw File
+ * 
+ * @param file     Address of FileManager
+ * @param compress Address of FileManager_Compress
+ * @param block    Address of raw Block Buffer
+ * @param blockLen sizeof raw Block Buffer (<= FILE_MANAGER_LZ_MAX_BLOCK)
+ * @param coded    Address of coded Block Buffer
+ * @param codedLen sizeof coded Block Buffer (>= blockLen + sizeof(FileManager_BlockHeader))
+ * @param index    Address of Block Index, Blocks after last Index Entry are found by Header hop
+ * @param indexLen Number of Index Entries (at least 1)
+ * @return FileManager_Result 
+ */
+FileManager_Result File_setCompression (FileManager* file, FileManager_Compress* compress, uint8_t* block, uint16_t blockLen, uint8_t* coded, uint16_t codedLen, FileManager_BlockIndex* index, uint16_t indexLen) {
+    FileManager_BlockHeader header;
+    FileManager_Result      fatFsResult;
+    FileManager_Size        size;
+
+    if (blockLen < 1 || codedLen < blockLen + sizeof(FileManager_BlockHeader) || indexLen < 1) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    compress->Block       = block;
+    compress->Coded       = coded;
+    compress->Index       = index;
+    compress->BlockLen    = blockLen;
+    compress->CodedLen    = codedLen;
+    compress->IndexLen    = indexLen;
+    compress->IndexCount  = 0;
+    compress->Fill        = 0;
+    compress->CachedLen   = 0;
+    compress->CachedStart = -1;
+    compress->LogicalEnd  = 0;
+    compress->PhysicalEnd = 0;
+    compress->RawBytes    = 0;
+    compress->CodedBytes  = 0;
+
+    file->InProcess = 1;
+    if (FileManager_detect(file->Volume) == 0) {
+        file->InProcess = 0;
+        return FileManager_DISK_ERR;
+    }
+    FileManager_mount(file->Volume);
+    if (file->FileStatus == FileManager_FileIsOpen) {
+        FileManager_closeFile(file);
+    }
+    fatFsResult = file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Read);
+    if (fatFsResult == FileManager_OK) {
+        size = file->Volume->Driver->FileSize(file);
+        while (compress->PhysicalEnd + sizeof(header) <= size && fatFsResult == FileManager_OK) {
+            fatFsResult = file->Volume->Driver->Lseek(file, compress->PhysicalEnd);
+            if (fatFsResult == FileManager_OK) {
+                fatFsResult = file->Volume->Driver->Read(file, &header, sizeof(header));
+            }
+            if (fatFsResult != FileManager_OK || file->PendingByte < sizeof(header) || header.Magic != FILE_MANAGER_BLOCK_MAGIC ||
+                compress->PhysicalEnd + sizeof(header) + header.CodedLen > size) {
+                break;                                      ///// torn Block, next Block overwrite it
+            }
+            if (compress->IndexCount < compress->IndexLen) {
+                compress->Index[compress->IndexCount].Logical  = compress->LogicalEnd;
+                compress->Index[compress->IndexCount].Physical = compress->PhysicalEnd;
+                compress->IndexCount++;
+            }
+            compress->LogicalEnd  += header.RawLen;
+            compress->PhysicalEnd += sizeof(header) + header.CodedLen;
+        }
+        file->Volume->Driver->Close(file);
+    }
+    file->InProcess = 0;
+    file->Compress  = compress;
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief compress raw Data of Block and write it at end of File
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_emitBlock (FileManager* file) {
+    FileManager_Compress*   c = file->Compress;
+    FileManager_BlockHeader header;
+    FileManager_Result      fatFsResult;
+    int32_t                 coded;
+
+    if (c->Fill == 0) {
+        return FileManager_OK;
+    }
+    coded        = FileManagerLZ_compress(c->Block, c->Fill, c->Coded + sizeof(header), c->CodedLen - sizeof(header));
+    header.Magic = FILE_MANAGER_BLOCK_MAGIC;
+    header.Flags = FileManager_BlockCoded;
+    if (coded < 0 || coded >= c->Fill) {
+        memcpy(c->Coded + sizeof(header), c->Block, c->Fill);
+        coded        = c->Fill;
+        header.Flags = FileManager_BlockStored;
+    }
+    header.RawLen   = c->Fill;
+    header.CodedLen = (uint16_t)coded;
+    memcpy(c->Coded, &header, sizeof(header));
+    coded      += sizeof(header);
+    fatFsResult = file->Volume->Driver->Lseek(file, c->PhysicalEnd);
+    if (fatFsResult == FileManager_OK) {
+        fatFsResult = file->Volume->Driver->Write(file, c->Coded, coded);
+        if (file->PendingByte < (uint32_t)coded) {
+            fatFsResult = FileManager_DENIED;
+        }
+    }
+    if (fatFsResult == FileManager_OK) {
+        if (c->IndexCount < c->IndexLen) {
+            c->Index[c->IndexCount].Logical  = c->LogicalEnd;
+            c->Index[c->IndexCount].Physical = c->PhysicalEnd;
+            c->IndexCount++;
+        }
+        c->RawBytes    += c->Fill;
+        c->CodedBytes  += coded;
+        c->LogicalEnd  += c->Fill;
+        c->PhysicalEnd += coded;
+        c->Fill         = 0;
+        FileManager_markDirty(file, coded);
+    }
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief move Data of write command from WriteStream into raw Block, full Block is written
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_compressWrite (FileManager* file) {
+    FileManager_Compress* c   = file->Compress;
+    int32_t               len = file->CommandHeaderInProcess.Len;
+
+    c->CachedStart = -1;                                    ///// Block is used for write now
+    if (len > c->BlockLen - c->Fill) {
+        len = c->BlockLen - c->Fill;
+    }
+    if (file->CommandHeaderInProcess.DataType == FileManager_Const) {
+        memcpy(c->Block + c->Fill, file->ConstVal, len);       ///// Data of Const is not in WriteStream
+        file->ConstVal += len;
+    }
+    else {
+        if (len > Stream_available(&file->WriteStream)) {
+            len = Stream_available(&file->WriteStream);
+        }
+        Stream_readBytes(&file->WriteStream, c->Block + c->Fill, len);
+    }
+    c->Fill                           += len;
+    file->CommandHeaderInProcess.Len  -= len;
+    if (c->Fill == c->BlockLen) {
+        return FileManager_emitBlock(file);
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief find Block which has Logical Address, Header of Block is read
+ * 
+ * @param file     Address of FileManager (File must be open)
+ * @param addr     Logical Address
+ * @param logical  Logical Address of Block
+ * @param physical Address of Block in File
+ * @param header   Header of Block
  * @return FileManager_Result 
  */
-FileManager_Result File_readBlocking (FileManager* file, int32_t addr, uint8_t* data, int32_t len) {
-    uint16_t                       tempLen     = 0;
-    uint8_t                        overFlow    = 0;
-    FileManager_Result             fatFSResult = 0; 
-    
-    FileManager_CommandHeader      cacheHeader;
-    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
-    cacheHeader.Addr               = addr;
-    cacheHeader.DataType           = FileManager_Var;
-    cacheHeader.Mode               = FileManager_ReadMode;
-    cacheHeader.Len                = len; 
-    uint8_t* pData = data;
-    
-    if (cacheHeader.Len < 1) {
+static FileManager_Result FileManager_locateBlock (FileManager* file, FileManager_Addr addr, FileManager_Addr* logical, FileManager_Addr* physical, FileManager_BlockHeader* header) {
+    FileManager_Compress* c    = file->Compress;
+    int32_t               low  = 0;
+    int32_t               high = c->IndexCount - 1;
+    int32_t               mid;
+    FileManager_Addr      end  = c->PhysicalEnd;
+    FileManager_Result    fatFsResult;
+
+    if (file->OtherPath) {
+        *logical  = 0;                                      ///// Index is for own File, Blocks of other Path are found by Header hop
+        *physical = 0;
+        end       = (FileManager_Addr)file->Volume->Driver->FileSize(file);
+        high      = -1;
+    }
+    else if (addr < 0 || addr >= c->LogicalEnd || c->IndexCount == 0) {
         return FileManager_INVALID_PARAMETER;
     }
-    file->InProcess = 1;
-    if (fileManagerDriver->IsDetected() == 1) {
-        fileManagerDriver->Mount(FileManager_ForceMount);
-        if (fileManagerDriver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Read) == FileManager_OK) {
-            fatFSResult = fileManagerDriver->Lseek(file, cacheHeader.Addr);
-            while(cacheHeader.Len > 0 && fatFSResult == FileManager_OK) {
-                overFlow           = cacheHeader.Len > file->Config->MaxSS ? 1                   : 0;
-                tempLen            = overFlow                              ? file->Config->MaxSS : cacheHeader.Len;
-                fatFSResult        = fileManagerDriver->Read(file, pData, tempLen);
-                while(file->PendingByte < tempLen - 1) {
+    while (low < high) {
+        mid = (low + high + 1) / 2;
+        if (c->Index[mid].Logical <= addr) {
+            low = mid;
+        }
+        else {
+            high = mid - 1;
+        }
+    }
+    if (high >= 0) {
+        *logical  = c->Index[low].Logical;
+        *physical = c->Index[low].Physical;
+    }
+    while (*physical + (FileManager_Addr)sizeof(*header) <= end) {
+        fatFsResult = file->Volume->Driver->Lseek(file, *physical);
+        if (fatFsResult == FileManager_OK) {
+            fatFsResult = file->Volume->Driver->Read(file, header, sizeof(*header));
+        }
+        if (fatFsResult != FileManager_OK || header->Magic != FILE_MANAGER_BLOCK_MAGIC) {
+            return fatFsResult != FileManager_OK ? fatFsResult : file->OtherPath ? FileManager_INVALID_PARAMETER : FileManager_INT_ERR;
+        }
+        if (addr < *logical + header->RawLen) {
+            return FileManager_OK;
+        }
+        *logical  += header->RawLen;                        ///// Block is after last Index Entry
+        *physical += sizeof(*header) + header->CodedLen;
+    }
+    return FileManager_INVALID_PARAMETER;
+}
+
+
+
+/**
+ * @brief read command on compressed File, only the Block of Address is read and decoded
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_compressRead (FileManager* file) {
+    FileManager_Compress*   c    = file->Compress;
+    FileManager_Addr        addr = file->CommandHeaderInProcess.Addr;
+    FileManager_Addr        logical;
+    FileManager_Addr        physical;
+    int32_t                 len;
+    FileManager_BlockHeader header;
+    FileManager_Result      fatFsResult;
+
+    if (c->Fill > 0) {
+        if (file->OtherPath) {
+            return FileManager_LOCKED;                      ///// raw Block of own File could not be written in beginCommand
+        }
+        fatFsResult = FileManager_emitBlock(file);          ///// raw Block is needed for decode
+        if (fatFsResult != FileManager_OK) {
+            return fatFsResult;
+        }
+    }
+    if (c->CachedStart < 0 || addr < c->CachedStart || addr >= c->CachedStart + c->CachedLen) {
+        c->CachedStart = -1;
+        fatFsResult    = FileManager_locateBlock(file, addr, &logical, &physical, &header);
+        if (fatFsResult == FileManager_OK) {
+            fatFsResult = header.CodedLen <= c->CodedLen ? file->Volume->Driver->Read(file, c->Coded, header.CodedLen) : FileManager_INT_ERR;
+        }
+        if (fatFsResult != FileManager_OK) {
+            return fatFsResult;
+        }
+        if (header.Flags == FileManager_BlockStored) {
+            memcpy(c->Block, c->Coded, header.RawLen);
+            len = header.RawLen;
+        }
+        else {
+            len = FileManagerLZ_decompress(c->Coded, header.CodedLen, c->Block, c->BlockLen);
+        }
+        if (len != header.RawLen) {
+            return FileManager_INT_ERR;
+        }
+        c->CachedStart = logical;
+        c->CachedLen   = header.RawLen;
+    }
+    len = c->CachedStart + c->CachedLen - addr;
+    if (len > file->CommandHeaderInProcess.Len) {
+        len = file->CommandHeaderInProcess.Len;
+    }
+    if (len > Stream_space(&file->ReadStream)) {
+        len = Stream_space(&file->ReadStream);
+    }
+    Stream_writeBytes(&file->ReadStream, c->Block + (addr - c->CachedStart), len);
+    file->CommandHeaderInProcess.Len  -= len;
+    file->CommandHeaderInProcess.Addr += len;
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief Enable CRC32C Framing of queued commands, each write command become
+ *        [FileManager_FrameHeader][Data][CRC32C] and read command (Address of Frame, Length of Data)
+ *        verify each Frame, corrupt Frame is reported by onError, its read command get no onRead and
+ *        onComplete get FileManager_CRC_ERR
+ * 
+ * @param file   Address of FileManager
+ * @param enable 1 -> enable, 0 -> disable
+ */
+void File_setFraming (FileManager* file, uint8_t enable) {
+    file->Framing   = enable ? 1 : 0;
+    file->FrameOpen = 0;
+}
+
+
+
+/**
+ * @brief write Frame Header before first chunk of write command
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_frameBegin (FileManager* file) {
+    FileManager_FrameHeader header;
+    FileManager_Result      fatFsResult;
+    header.Magic    = FILE_MANAGER_FRAME_MAGIC;
+    header.Reserved = 0;
+    header.Len      = file->CommandHeaderInProcess.Len;
+    file->FrameAddr = file->CommandHeaderInProcess.Addr != END_OF_FILE ? file->CommandHeaderInProcess.Addr : (FileManager_Addr)file->Volume->Driver->FileSize(file);
+    fatFsResult     = file->Volume->Driver->Write(file, &header, sizeof(header));
+    if (file->PendingByte < sizeof(header)) {
+        fatFsResult = FileManager_INVALID_DRIVE;
+    }
+    if (fatFsResult == FileManager_OK) {
+        if (file->CommandHeaderInProcess.Addr != END_OF_FILE) {
+            file->CommandHeaderInProcess.Addr += sizeof(header);
+        }
+        file->FrameCrc  = FILE_MANAGER_CRC_INIT;
+        file->FrameOpen = 1;
+        FileManager_markDirty(file, sizeof(header));
+    }
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief write CRC32C after last chunk of write command
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_frameEnd (FileManager* file) {
+    uint32_t           crc = FileManagerCRC_final(file->FrameCrc);
+    FileManager_Result fatFsResult;
+    fatFsResult = file->Volume->Driver->Write(file, &crc, sizeof(crc));
+    if (file->PendingByte < sizeof(crc)) {
+        fatFsResult = FileManager_INVALID_DRIVE;
+    }
+    if (fatFsResult == FileManager_OK) {
+        if (file->CommandHeaderInProcess.Addr != END_OF_FILE) {
+            file->CommandHeaderInProcess.Addr += sizeof(crc);
+        }
+        file->FrameOpen = 0;
+        FileManager_markDirty(file, sizeof(crc));
+    }
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief report corrupt Frame and skip rest of read command, Data of command is dropped from ReadStream
+ *        so onRead is not called and onComplete get FileManager_CRC_ERR
+ */
+static void FileManager_frameError (FileManager* file) {
+    if (file->Callbacks.onError != NULL) {
+        file->Callbacks.onError(file, FileManager_CRC_ERR, file->FrameAddr);
+    }
+    Stream_moveReadPos(&file->ReadStream, file->ReadCommand.Len - file->CommandHeaderInProcess.Len);
+    file->FrameOpen                  = 0;
+    file->CommandHeaderInProcess.Len = 0;
+}
+
+
+
+/**
+ * @brief read command on framed File, Data of Frames go into ReadStream and CRC of each Frame is verified,
+ *        when command end in middle of Frame rest of Frame is read (not into ReadStream) to verify it
+ * 
+ * @param file Address of FileManager (File must be open and seek to Address of command)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_frameRead (FileManager* file) {
+    FileManager_FrameHeader header;
+    FileManager_Result      fatFsResult = FileManager_OK;
+    uint32_t                crc;
+    int32_t                 len;
+    int32_t                 tail;
+
+    if (!file->FrameOpen) {
+        fatFsResult = file->Volume->Driver->Read(file, &header, sizeof(header));
+        if (fatFsResult != FileManager_OK) {
+            return fatFsResult;
+        }
+        file->FrameAddr = file->CommandHeaderInProcess.Addr;
+        if (file->PendingByte < sizeof(header) || header.Magic != FILE_MANAGER_FRAME_MAGIC || header.Len < 0) {
+            FileManager_frameError(file);
+            return FileManager_CRC_ERR;
+        }
+        file->CommandHeaderInProcess.Addr += sizeof(header);
+        file->FrameRemain                  = header.Len;
+        file->FrameCrc                     = FILE_MANAGER_CRC_INIT;
+        file->FrameOpen                    = 1;
+    }
+    len = file->FrameRemain;
+    if (len > file->CommandHeaderInProcess.Len) {
+        len = file->CommandHeaderInProcess.Len;
+    }
+    if (len > file->Config->MaxSS) {
+        len = file->Config->MaxSS;
+    }
+    if (len > Stream_directSpace(&file->ReadStream)) {
+        len = Stream_directSpace(&file->ReadStream);
+    }
+    if (len > 0) {
+        fatFsResult = file->Volume->Driver->Read(file, Stream_getWritePtr(&file->ReadStream), len);
+        if (fatFsResult != FileManager_OK || file->PendingByte < (uint32_t)len) {
+            return fatFsResult != FileManager_OK ? fatFsResult : FileManager_INVALID_DRIVE;
+        }
+        file->FrameCrc = FileManagerCRC_update(file->FrameCrc, Stream_getWritePtr(&file->ReadStream), len);
+        Stream_moveWritePos(&file->ReadStream, len);
+        file->FrameRemain                 -= len;
+        file->CommandHeaderInProcess.Len  -= len;
+        file->CommandHeaderInProcess.Addr += len;
+    }
+    while (file->CommandHeaderInProcess.Len < 1 && file->FrameRemain > 0) {
+        tail = file->FrameRemain > (int32_t)sizeof(swapBuffer) ? (int32_t)sizeof(swapBuffer) : file->FrameRemain;
+        fatFsResult = file->Volume->Driver->Read(file, swapBuffer, tail);   ///// only CRC need rest of Frame
+        if (fatFsResult != FileManager_OK || file->PendingByte < (uint32_t)tail) {
+            FileManager_frameError(file);
+            return fatFsResult != FileManager_OK ? fatFsResult : FileManager_CRC_ERR;
+        }
+        file->FrameCrc     = FileManagerCRC_update(file->FrameCrc, (uint8_t*)swapBuffer, tail);
+        file->FrameRemain -= tail;
+    }
+    if (file->FrameRemain == 0) {
+        fatFsResult = file->Volume->Driver->Read(file, &crc, sizeof(crc));
+        if (fatFsResult != FileManager_OK) {
+            return fatFsResult;
+        }
+        file->CommandHeaderInProcess.Addr += sizeof(crc);
+        file->FrameOpen                    = 0;
+        if (file->PendingByte < sizeof(crc) || crc != FileManagerCRC_final(file->FrameCrc)) {
+            FileManager_frameError(file);
+            return FileManager_CRC_ERR;
+        }
+    }
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief read next chunk of File_readStream into free space of ReadStream and give it to onReadChunk,
+ *        nothing is read until consumer free space of ReadStream (flow control),
+ *        empty chunk at end of File is not given (onComplete end command)
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_streamRead (FileManager* file) {
+    FileManager_Result fatFsResult;
+    int32_t            len = file->CommandHeaderInProcess.Len;
+
+    if (len > Stream_directSpace(&file->ReadStream)) {
+        len = Stream_directSpace(&file->ReadStream);
+    }
+    if (len > file->Config->MaxSS) {
+        len = file->Config->MaxSS;
+    }
+    if (len < 1) {
+        return FileManager_OK;                              ///// ReadStream is full, wait for consumer
+    }
+    fatFsResult = file->Volume->Driver->Read(file, Stream_getWritePtr(&file->ReadStream), len);
+    if (fatFsResult != FileManager_OK) {
+        return fatFsResult;
+    }
+    Stream_moveWritePos(&file->ReadStream, file->PendingByte);
+    if ((int32_t)file->PendingByte < len) {
+        file->CommandHeaderInProcess.Len = file->PendingByte; ///// end of File
+    }
+    file->CommandHeaderInProcess.Len  -= file->PendingByte;
+    file->CommandHeaderInProcess.Addr += file->PendingByte;
+    if (file->Callbacks.onReadChunk != NULL && file->PendingByte > 0) {
+        file->Callbacks.onReadChunk(file, &file->ReadStream, file->CommandHeaderInProcess.Addr - file->PendingByte, file->PendingByte, file->CommandHeaderInProcess.Len);
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief give one window of mapped File to onRead
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_mapRead (FileManager* file) {
+    FileManager_CommandHeader windowCommand;
+    Stream                    view;
+    const uint8_t*            data;
+    FileManager_Result        fatFsResult;
+    FileManager_Addr          end = (FileManager_Addr)file->Volume->Driver->FileSize(file) - file->CommandHeaderInProcess.Addr;
+    int32_t                   len;
+
+    if (file->CommandHeaderInProcess.Len > end) {
+        file->CommandHeaderInProcess.Len = end > 0 ? (int32_t)end : 0;   ///// read which cross end of File is cut at end of File
+    }
+    len = file->CommandHeaderInProcess.Len;
+    if (len < 1) {
+        file->Volume->Driver->UnMap(file);
+        return FileManager_OK;
+    }
+    if (len > (int32_t)FILE_MANAGER_MAP_WINDOW) {
+        len = FILE_MANAGER_MAP_WINDOW;
+    }
+    fatFsResult = file->Volume->Driver->Map(file, file->CommandHeaderInProcess.Addr, len, &data);
+    if (fatFsResult != FileManager_OK) {
+        file->CommandHeaderInProcess.Len = 0;
+        file->Volume->Driver->UnMap(file);
+        return fatFsResult;
+    }
+    memcpy(&windowCommand, &file->CommandHeaderInProcess, sizeof(windowCommand));
+    windowCommand.Len = len;
+    if (file->Callbacks.onRead != NULL) {
+        Stream_init(&view, (uint8_t*)data, len);
+        Stream_moveWritePos(&view, len);
+        file->Callbacks.onRead(file, &view, &windowCommand);
+    }
+    file->CommandHeaderInProcess.Len  -= len;
+    file->CommandHeaderInProcess.Addr += len;
+    if (file->CommandHeaderInProcess.Len < 1) {
+        file->Volume->Driver->UnMap(file);
+    }
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief swap Bytes of elements of complete read command in ReadStream (DataType is element size),
+ *        element which cross end of ReadStream Buffer is swapped through a small copy
+ */
+static void FileManager_swapRead (FileManager* file) {
+    Stream   view = file->ReadStream;
+    uint8_t  size = file->ReadCommand.DataType;
+    uint8_t  element[8];
+    uint8_t* first;
+    int32_t  len;
+    int32_t  tempLen;
+    if (size != FileManager_Swap16 && size != FileManager_Swap32 && size != FileManager_Swap64) {
+        return;
+    }
+    len = Stream_available(&view) < file->ReadCommand.Len ? Stream_available(&view) : file->ReadCommand.Len;
+    len = len / size * size;
+    while (len > 0) {
+        tempLen = Stream_directAvailable(&view) / size * size;
+        tempLen = tempLen < len ? tempLen : len;
+        if (tempLen > 0) {
+            FileManagerSwap_copy(Stream_getReadPtr(&view), Stream_getReadPtr(&view), tempLen / size, size);
+            Stream_moveReadPos(&view, tempLen);
+        }
+        else {
+            first   = Stream_getReadPtr(&view);
+            tempLen = Stream_directAvailable(&view);
+            memcpy(element, first, tempLen);
+            Stream_moveReadPos(&view, tempLen);
+            memcpy(element + tempLen, Stream_getReadPtr(&view), size - tempLen);
+            FileManagerSwap_copy(element, element, 1, size);
+            memcpy(first, element, tempLen);
+            memcpy(Stream_getReadPtr(&view), element + tempLen, size - tempLen);
+            Stream_moveReadPos(&view, size - tempLen);
+            tempLen = size;
+        }
+        len -= tempLen;
+    }
+}
+
+
+
+/**
+ * @brief call onRead when read command is complete
+ */
+static void FileManager_deliverRead (FileManager* file, FileManager_CommandHeader* readCommand) {
+    Stream readTempStream;
+    if (file->CommandHeaderInProcess.Len < 1) {
+        FileManager_swapRead(file);
+    }
+    if (file->Callbacks.onRead != NULL && file->CommandHeaderInProcess.Len < 1) {
+        Stream_lockRead (&file->ReadStream, &readTempStream, Stream_available(&file->ReadStream) < readCommand->Len ? Stream_available(&file->ReadStream) : readCommand->Len);
+        file->Callbacks.onRead (file, &readTempStream, readCommand);
+        Stream_unlockRead (&file->ReadStream, &readTempStream);
+    }
+}
+
+
+
+/**
+ * @brief prepare command which is just read from CommandQueue
+ * 
+ * @param file Address of FileManager
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_beginCommand (FileManager* file) {
+    char               pathBuffer[MAX_PATH_LENGTH];
+    FileManager_Result fatFsResult = FileManager_OK;
+    file->FirstTimeRun = 1;
+    file->FrameOpen    = 0;
+
+    switch (file->CommandHeaderInProcess.Mode) {
+        case FileManager_WriteMode :
+            if (file->CommandHeaderInProcess.DataType == FileManager_Const) {
+                Stream_readBytes(&file->WriteStream, (uint8_t*)&file->ConstVal, sizeof(file->ConstVal));   ///// File_write put whole pointer
+            }
+            break;
+        case FileManager_FillMode:
+            Stream_readBytes(&file->WriteStream, &file->FillPattern, sizeof(file->FillPattern));
+            break;
+        case FileManager_CopyMode:
+            Stream_readBytes(&file->WriteStream, (uint8_t*)&file->CopySrc, sizeof(file->CopySrc));
+            Stream_readBytes(&file->WriteStream, (uint8_t*)&file->CopyAddr, sizeof(file->CopyAddr));
+            break;
+        case FileManager_ReadMode:
+            memcpy (&file->ReadCommand, &file->CommandHeaderInProcess, sizeof(FileManager_CommandHeader));
+            break;
+#if FILE_MANAGER_USE_FOR_LOGGER
+        case FileManager_LoggerReadMode :
+            memcpy (&file->ReadCommand, &file->CommandHeaderInProcess, sizeof(FileManager_CommandHeader));
+            snprintf (pathBuffer, MAX_PATH_LENGTH - 1, FILE_MANAGER_PATH_FORMAT, ((FileManager_RecFrame*)file->Args1)->DeviceId,
+               ((FileManager_RecFrame*)file->Args1)->Indicator, file->CommandHeaderInProcess.DT.Year,
+               file->CommandHeaderInProcess.DT.Month, file->CommandHeaderInProcess.DT.Day,
+               file->CommandHeaderInProcess.DT.Hour, file->CommandHeaderInProcess.DT.Minute);
+            if (file->Compress != NULL && file->Compress->Fill > 0 && !file->OtherPath) {
+                if (file->FileStatus != FileManager_FileIsOpen &&
+                    file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Write | FileManager_Read) == FileManager_OK) {
+                    file->FileStatus = FileManager_FileIsOpen;
+                }
+                if (file->FileStatus == FileManager_FileIsOpen) {
+                    FileManager_emitBlock(file);            ///// Block buffer is used to decode other Path
                 }
-                cacheHeader.Len    -= tempLen;
-                pData              += tempLen;
             }
-            
-         fatFSResult = fileManagerDriver->Close(file);
-         file->InProcess           = 0;
+            if (file->Compress != NULL) {
+                file->Compress->CachedStart = -1;
+            }
+            if (file->FileStatus == FileManager_FileIsOpen) {
+                FileManager_closeFile(file);
+            }
+            fatFsResult = file->Volume->Driver->Open(file, (uint8_t*)pathBuffer, FileManager_OpenAlways | FileManager_Write | FileManager_Read);
+            file->OtherPath = fatFsResult == FileManager_OK;
+            break;
+#endif
+    }
+    return fatFsResult;
+}
+
+
+
+/**
+ * @brief drop command in process when it is canceled, its Bytes in WriteStream are skipped and onComplete get FileManager_DENIED
+ * 
+ * @return uint8_t 1 -> command is dropped
+ */
+static uint8_t FileManager_dropCanceled (FileManager* file) {
+    FileManager_CommandHeader* command = &file->CommandHeaderInProcess;
+    uint8_t                    i;
+    for (i = 0; i < file->CancelCount && file->Canceled[i] != command->Id; i++) {
+    }
+    if (i == file->CancelCount) {
+        return 0;
+    }
+    file->Canceled[i] = file->Canceled[--file->CancelCount];
+    if (command->Mode == FileManager_WriteMode && command->DataType == FileManager_Var) {
+        Stream_moveReadPos(&file->WriteStream, command->Len);
+    }
+    else if (command->Mode == FileManager_WriteMode || command->Mode == FileManager_FillMode || command->Mode == FileManager_CopyMode) {
+        FileManager_beginCommand(file);                     ///// read parameters of command out of WriteStream
+    }
+    if (command->Mode == FileManager_WriteMode || command->Mode == FileManager_FillMode || command->Mode == FileManager_CopyMode) {
+        file->Stats.DroppedBytes += command->Len;
+    }
+    command->Len = 0;
+    if (file->Callbacks.onComplete != NULL) {
+        file->Callbacks.onComplete(file, command, FileManager_DENIED);
+    }
+    return 1;
+}
+
+
+
+/**
+ * @brief read next command out of CommandQueue, canceled command is dropped here
+ * 
+ * @return uint8_t 1 -> command must run
+ */
+static uint8_t FileManager_dequeue (FileManager* file) {
+    Queue_readItem(&file->CommandQueue, &file->CommandHeaderInProcess);
+    file->StartedId = file->CommandHeaderInProcess.Id;
+#if FILE_MANAGER_USE_ASYNC
+    if (file->AsyncCount > 0 && FileManager_isCanceled(file, file->StartedId)) {
+        file->AsyncWait = 1;                                ///// Bytes of chunks in flight are before its Data, drop it after them
+        return 0;
+    }
+#endif
+    return !FileManager_dropCanceled(file);
+}
+
+
+
+#if FILE_MANAGER_USE_ASYNC
+/**
+ * @brief check region overlap a write chunk in flight, chunks complete in any order
+ *        so overlapping chunk must wait until older one is retired
+ */
+static uint8_t FileManager_asyncOverlap (FileManager* file, FileManager_Addr addr, int32_t len) {
+    FileManager_AsyncOp* op;
+    uint8_t              i;
+    for (i = 0; i < file->AsyncCount; i++) {
+        op = &file->AsyncOps[(file->AsyncHead + i) % FILE_MANAGER_ASYNC_DEPTH];
+        if (op->Mode == FileManager_WriteMode && op->Addr < addr + len && addr < op->Addr + op->Len) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+
+/**
+ * @brief check command in process can run on async driver
+ */
+static uint8_t FileManager_asyncable (FileManager* file) {
+    if (file->Compress != NULL || file->Framing || file->OtherPath) {
+        return 0;
+    }
+    return (file->CommandHeaderInProcess.Mode == FileManager_WriteMode && file->CommandHeaderInProcess.DataType == FileManager_Var) ||
+            file->CommandHeaderInProcess.Mode == FileManager_ReadMode;
+}
+
+
+
+/**
+ * @brief submit chunks of command in process until queue depth or Stream is full
+ *        chunks point directly into WriteStream/ReadStream, Streams move when chunk is retired
+ * 
+ * @param file Address of FileManager (File must be open)
+ * @return FileManager_Result 
+ */
+static FileManager_Result FileManager_asyncSubmit (FileManager* file) {
+    FileManager_CommandHeader* command = &file->CommandHeaderInProcess;
+    FileManager_AsyncOp*       op;
+    FileManager_Result         result  = FileManager_OK;
+    int32_t                    len;
+    FileManager_Addr           size;
+
+    if (command->Addr == END_OF_FILE) {
+        size          = file->Volume->Driver->FileSize(file);
+        command->Addr = file->AsyncCount > 0 && file->AsyncEnd > size ? file->AsyncEnd : size;
+    }
+    if (command->Mode == FileManager_ReadMode && file->AsyncCount == 0) {
+        size = file->Volume->Driver->FileSize(file);        ///// read run alone, size can not change while its chunks are in flight
+        if (command->Addr + command->Len > size) {
+            len                    = command->Addr < size ? (int32_t)(size - command->Addr) : 0;
+            file->ReadCommand.Len -= command->Len - len;    ///// read after end of File give only Bytes up to end
+            command->Len           = len;
+        }
+    }
+    while (command->Len > 0 && file->AsyncCount < FILE_MANAGER_ASYNC_DEPTH) {
+        if (command->Mode == FileManager_WriteMode) {
+            len = Stream_directAvailable(&file->WriteStream) - file->AsyncBytes;
+        }
+        else {
+            len = Stream_directSpace(&file->ReadStream) - file->AsyncBytes;
+        }
+        if (len > command->Len) {
+            len = command->Len;
+        }
+        if (len > file->Config->MaxSS * FILE_MANAGER_ASYNC_SECTORS) {
+            len = file->Config->MaxSS * FILE_MANAGER_ASYNC_SECTORS;
+        }
+        if (len <= 0) {
+            break;                                          ///// Stream wrap here, wait for retire
+        }
+        if (command->Mode == FileManager_WriteMode && FileManager_asyncOverlap(file, command->Addr, len)) {
+            break;                                          ///// older write of same region is in flight
+        }
+        op          = &file->AsyncOps[(file->AsyncHead + file->AsyncCount) % FILE_MANAGER_ASYNC_DEPTH];
+        op->Data    = (command->Mode == FileManager_WriteMode ? Stream_getReadPtr(&file->WriteStream) : Stream_getWritePtr(&file->ReadStream)) + file->AsyncBytes;
+        op->Addr    = command->Addr;
+        op->Len     = len;
+        op->Mode    = command->Mode;
+        op->Result  = 0;
+        op->Done    = 0;
+        op->Last    = len == command->Len;
+        op->Retries = 0;
+        op->Id      = command->Id;
+        result      = file->Volume->Driver->Submit(file, op);
+        if (result != FileManager_OK) {
+            break;
+        }
+        file->AsyncCount++;
+        file->AsyncBytes += len;
+        command->Len     -= len;
+        command->Addr    += len;
+        if (command->Addr > file->AsyncEnd || file->AsyncCount == 1) {
+            file->AsyncEnd = command->Addr;
+        }
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief handle File on async driver, chunks of many commands stay in flight together
+ *        commands which need sync driver wait until all chunks are complete
+ * 
+ * @param file Address of FileManager
+ * @return uint8_t 1 -> File is handled, 0 -> sync path must handle File
+ */
+static uint8_t FileManager_asyncHandle (FileManager* file) {
+    FileManager_CommandHeader* command = &file->CommandHeaderInProcess;
+
+    if (file->Volume->Driver->Submit == NULL || file->Volume->Driver->Poll == NULL) {
+        return 0;
+    }
+    FileManager_asyncRetire(file);
+    if (file->AsyncCount == 0 && file->FileStatus == FileManager_FileIsOpen && file->SyncPolicy != FileManager_SyncOnClose) {
+        FileManager_commit(file, command->Len < 1);         ///// OnClose File stay open until queue is empty
+    }
+    if (file->AsyncRead && command->Len < 1 && file->AsyncCount == 0) {
+        file->AsyncRead = 0;
+        FileManager_deliverRead(file, &file->ReadCommand);
+        if (file->Callbacks.onComplete != NULL) {
+            file->Callbacks.onComplete(file, &file->ReadCommand, (FileManager_Result)file->AsyncResult);
+        }
+        file->AsyncResult = FileManager_OK;
+    }
+    if (command->Len < 1 && !file->AsyncWait && !file->AsyncRead && Queue_available(&file->CommandQueue) > 0) {
+        if (file->AsyncCount == 0) {
+            FileManager_mount(file->Volume);
+        }
+        if (FileManager_dequeue(file)) {
+            file->AsyncWait = !FileManager_asyncable(file) || (command->Mode == FileManager_ReadMode && file->AsyncCount > 0);
+            if (!file->AsyncWait) {
+                FileManager_beginCommand(file);
+                file->AsyncRead = command->Mode == FileManager_ReadMode;
+            }
         }
-        else {
-            fatFSResult = FileManager_INT_ERR;
+    }
+    if (file->AsyncWait || command->Len < 1 || !FileManager_asyncable(file)) {
+        return file->AsyncCount > 0;                        ///// sync path run when no chunk is in flight
+    }
+    if (file->FileStatus != FileManager_FileIsOpen) {
+        if (file->Volume->Driver->Open(file, file->Path, FileManager_OpenAlways | FileManager_Write | FileManager_Read) != FileManager_OK) {
+            return 0;
         }
+        file->FileStatus = FileManager_FileIsOpen;
     }
-    else {
-        if (file->Callbacks.onNotDetect != NULL) {
-            file->Callbacks.onNotDetect();
+    if (file->FirstTimeRun && command->Mode == FileManager_WriteMode && file->UseForLogger) {
+        if (file->AsyncCount == 0 && file->Volume->Driver->FileSize(file) == 0 && file->Callbacks.onCreateFile != NULL) {
+            file->Callbacks.onCreateFile(file);
         }
-       fatFSResult = FileManager_DISK_ERR;
+        if (file->Callbacks.onGetAddress != NULL) {
+            file->Callbacks.onGetAddress(file);
+        }
+        file->FirstTimeRun = 0;
     }
-    return fatFSResult;
+    FileManager_asyncSubmit(file);
+    return file->AsyncCount > 0 || (file->AsyncRead && command->Len < 1);   ///// nothing submitted -> sync path, read after end of File is delivered in next pass
 }
+#endif
 
 
 
@@ -210,7 +2867,7 @@ FileManager_Result File_readBlocking (FileManager* file, int32_t addr, uint8_t*
  * @return FileManager_Timestamp 
  */
 FileManager_Timestamp  FileManager_getTimeStamp (void) {
-   return (FileManager_Timestamp)fileManagerDriver->GetTimestamp();
+   return (FileManager_Timestamp)defaultVolume.Driver->GetTimestamp();
 }
 
 
@@ -226,9 +2883,9 @@ FileManager_Timestamp  FileManager_getTimeStamp (void) {
  * @param data Address of Data u want to write in SdCard
  * @param len  Length Of Data u want to Write into SdCard
  * @param type Type of your Data FileManager_Const/Var
- * @return FileManager_Result 
+ * @return FileManager_Result FileManager_NOT_ENABLED if addr is not END_OF_FILE on compressed File
  */
-FileManager_Result File_write (FileManager* file, int32_t addr, uint8_t* data, int32_t len, FileManager_Type type) {
+FileManager_Result File_write (FileManager* file, FileManager_Addr addr, uint8_t* data, int32_t len, FileManager_Type type) {
     FileManager_CommandHeader cacheHeader;
     memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
     cacheHeader.Addr           = addr;
@@ -237,17 +2894,32 @@ FileManager_Result File_write (FileManager* file, int32_t addr, uint8_t* data, i
     cacheHeader.Mode           = FileManager_WriteMode;
     
     if(cacheHeader.Len > 0) {
-        Queue_writeItem(&file->CommandQueue, &cacheHeader);
+        if (file->Compress != NULL && addr != END_OF_FILE) {
+            return FileManager_NOT_ENABLED;                 ///// compressed File only append
+        }
+        if (cacheHeader.DataType == FileManager_Var && file->Dedupe && addr != END_OF_FILE && FileManager_dedupe(file, addr, data, len)) {
+            return FileManager_OK;
+        }
+        if (Queue_space(&file->CommandQueue) == 0 ||
+            Stream_space(&file->WriteStream) < (cacheHeader.DataType == FileManager_Var ? len : (int32_t)sizeof(data)) ||
+            (cacheHeader.DataType == FileManager_Var && !FileManager_pendingAdd(file, addr, len, file->WriteTotal, file->LastId + 1))) {
+            return FileManager_NOT_ENOUGH_CORE;
+        }
+        FileManager_enqueue(file, &cacheHeader);
     }
     else {
         return FileManager_INVALID_PARAMETER;
     }
     switch (cacheHeader.DataType) {
         case FileManager_Var:
-            Stream_writeBytes(&file->WriteStream, data, len);
+            FileManager_streamWrite(file, data, len);
+            if (file->Dedupe && addr != END_OF_FILE) {
+                FileManager_dedupeCancel(file, addr, len);
+            }
             break;
         case FileManager_Const:
-            Stream_writeBytes(&file->WriteStream, (uint8_t*)&data, sizeof(data));
+            FileManager_streamWrite(file, (uint8_t*)&data, sizeof(data));
+            FileManager_barrierAdd(file, addr, len);
             break;
     }
     return FileManager_OK;
@@ -266,10 +2938,12 @@ FileManager_Result File_write (FileManager* file, int32_t addr, uint8_t* data, i
  * @param addr 
  * @param tempStream 
  * @param len 
- * @return Stream* 
+ * @return Stream* NULL if CommandQueue or pending map has no space for command of Data (nothing is locked)
  */
 Stream* File_beginWrite (FileManager* file, Stream* tempStream, int32_t len) {
-    
+    if (Queue_space(&file->CommandQueue) == 0 || !FileManager_pendingSpace(file)) {
+        return NULL;
+    }
     if (len > 0) {
         Stream_lockWrite(&file->WriteStream, tempStream, len);
     }
@@ -289,16 +2963,34 @@ Stream* File_beginWrite (FileManager* file, Stream* tempStream, int32_t len) {
  * @param file Address of FileManager
  * @param addr 
  * @param tempStream 
+ * @return FileManager_Result FileManager_NOT_ENOUGH_CORE if CommandQueue or pending map is full,
+ *         FileManager_NOT_ENABLED if addr is not END_OF_FILE on compressed File, locked Bytes are dropped then
  */
-void File_endWrite (FileManager* file, int32_t addr, Stream* tempStream) {
+FileManager_Result File_endWrite (FileManager* file, FileManager_Addr addr, Stream* tempStream) {
     FileManager_CommandHeader cacheHeader;
+    FileManager_Result        result = FileManager_OK;
+    int32_t                   available;
     memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
     cacheHeader.Addr     = addr;
     cacheHeader.Len      = Stream_available(tempStream);
     cacheHeader.DataType = FileManager_Var;
     cacheHeader.Mode     = FileManager_WriteMode;
-    Queue_writeItem(&file->CommandQueue, &cacheHeader);
+    available            = Stream_available(&file->WriteStream);
+    if (file->Compress != NULL && addr != END_OF_FILE) {
+        result = FileManager_NOT_ENABLED;                   ///// compressed File only append
+    }
+    else if (Queue_space(&file->CommandQueue) == 0 || !FileManager_pendingAdd(file, addr, cacheHeader.Len, file->WriteTotal, file->LastId + 1)) {
+        result = FileManager_NOT_ENOUGH_CORE;
+    }
+    if (result != FileManager_OK) {
+        Stream_lockWrite(&file->WriteStream, tempStream, 0);
+        Stream_unlockWrite(&file->WriteStream, tempStream);  ///// empty lock, Bytes without command never enter WriteStream
+        return result;
+    }
+    FileManager_enqueue(file, &cacheHeader);
     Stream_unlockWrite(&file->WriteStream, tempStream);
+    file->WriteTotal    += Stream_available(&file->WriteStream) - available;
+    return FileManager_OK;
 }
 
 
@@ -314,14 +3006,14 @@ void File_endWrite (FileManager* file, int32_t addr, Stream* tempStream) {
  * @param len Length 
  * @return Stream* 
  */
-Stream* File_beginRead (FileManager* file, int32_t addr, Stream* tempStream, int32_t len) {
+Stream* File_beginRead (FileManager* file, FileManager_Addr addr, Stream* tempStream, int32_t len) {
     FileManager_CommandHeader cacheHeader;
     memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
     cacheHeader.Addr           = addr;
     cacheHeader.Len            = len;
     cacheHeader.DataType       = FileManager_Var;
     cacheHeader.Mode           = FileManager_ReadMode;
-    Queue_writeItem (&file->CommandQueue, &cacheHeader);
+    FileManager_enqueue(file, &cacheHeader);
     Stream_lockRead (&file->ReadStream, tempStream, len);
     return tempStream;
 }
@@ -350,7 +3042,7 @@ void File_endRead (FileManager* file, Stream* tempStream) {
  * @param len Data Length
  * @return FileManager_Result 
  */
-FileManager_Result File_loggerRead (FileManager* file, DateTime_X* dateTime, int32_t addr, int32_t len) {
+FileManager_Result File_loggerRead (FileManager* file, DateTime_X* dateTime, FileManager_Addr addr, int32_t len) {
     FileManager_CommandHeader cacheHeader;
     cacheHeader.DT.Date     = dateTime->Date;
     cacheHeader.DT.Time     = dateTime->Time;
@@ -362,10 +3054,7 @@ FileManager_Result File_loggerRead (FileManager* file, DateTime_X* dateTime, int
     if (cacheHeader.Len < 1) {
         return FileManager_INVALID_PARAMETER;
     }
-    else {
-        Queue_writeItem (&file->CommandQueue, &cacheHeader);
-    }
-    return FileManager_OK;
+    return FileManager_enqueue(file, &cacheHeader);
 }
 
 #endif
@@ -381,7 +3070,7 @@ FileManager_Result File_loggerRead (FileManager* file, DateTime_X* dateTime, int
  * @param len  Length Of Data u want to Read from SdCard
  * @return FileManager_Result 
  */
-FileManager_Result File_read (FileManager* file, int32_t addr, int32_t len) {
+FileManager_Result File_read (FileManager* file, FileManager_Addr addr, int32_t len) {
     FileManager_CommandHeader cacheHeader;
     memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
     cacheHeader.Addr           = addr;
@@ -392,20 +3081,163 @@ FileManager_Result File_read (FileManager* file, int32_t addr, int32_t len) {
     if(cacheHeader.Len < 1) {
         return FileManager_INVALID_PARAMETER;
     }
-    else {
-        Queue_writeItem(&file->CommandQueue, &cacheHeader);
+    return FileManager_enqueue(file, &cacheHeader);
+}
+
+
+
+
+/**
+ * @brief NonBlocking zero copy Read, driver Map File into memory and onRead get Stream over mapped Data
+ *        (FILE_MANAGER_MAP_WINDOW Bytes in each call), no ReadStream is used so len has no limit, read is cut at end of File
+ *        if driver has no Map, or File is compressed or framed (mapped Bytes would be Blocks/Frames, not decoded or verified), it work like File_read
+ * 
+ * @param file Address of FileManager Struct
+ * @param addr FileAddress u want to Read From that
+ * @param len  Length Of Data u want to Read
+ * @return FileManager_Result 
+ */
+FileManager_Result File_readMapped (FileManager* file, FileManager_Addr addr, int32_t len) {
+    FileManager_CommandHeader cacheHeader;
+    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
+    cacheHeader.Addr           = addr;
+    cacheHeader.Len            = len;
+    cacheHeader.DataType       = FileManager_Var;
+    cacheHeader.Mode           = file->Volume->Driver->Map != NULL && file->Compress == NULL && !file->Framing ? FileManager_MapReadMode : FileManager_ReadMode;
+
+    if (cacheHeader.Len < 1 || cacheHeader.Addr < 0) {
+        return FileManager_INVALID_PARAMETER;
     }
-    return FileManager_OK;
+    return FileManager_enqueue(file, &cacheHeader);
+}
+
+
+
+
+/**
+ * @brief NonBlocking streaming Read, onReadChunk is called for each chunk (at most MaxSS Bytes) which is read into ReadStream,
+ *        consumer read Bytes out of stream (in callback or later) and handler read more only into free space,
+ *        so len has no limit and ReadStream can be small (not for compressed or framed File)
+ * 
+ * @param file Address of FileManager Struct
+ * @param addr FileAddress u want to Read From that
+ * @param len  Length Of Data u want to Read
+ * @return FileManager_Result 
+ */
+FileManager_Result File_readStream (FileManager* file, FileManager_Addr addr, int32_t len) {
+    FileManager_CommandHeader cacheHeader;
+    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
+    cacheHeader.Addr           = addr;
+    cacheHeader.Len            = len;
+    cacheHeader.DataType       = FileManager_Var;
+    cacheHeader.Mode           = FileManager_StreamReadMode;
+
+    if (cacheHeader.Len < 1 || cacheHeader.Addr < 0 || file->Compress != NULL || file->Framing) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    return FileManager_enqueue(file, &cacheHeader);
 }
 
 
 
 
 FileManager_Result FileManager_setNewPath (FileManager* file, uint8_t* newPath) {
+    if (newPath == NULL) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    FileManager_unlinkPath(file);
     file->Path = newPath;
+    FileManager_linkPath(file);
+    return FileManager_OK;
+}
+
+
+/**
+ * @brief remove File from FileManager, open File is closed and queued commands are dropped
+ *        (command in process, Streams, pending map and cancel list are cleared),
+ *        other Files which use it as checkpoint marker or copy source of command in process lose it
+ *        (do not call it from callbacks of FileManager_handle)
+ * 
+ * @param file Address Of FileManager Struct
+ * @return FileManager_Result 
+ */
+FileManager_Result FileManager_remove (FileManager* file) {
+    FileManager_CommandHeader command;
+    FileManager*              pFile;
+    if (FILE_MANAGER_NULL == file) {
+        return FileManager_NO_FILE;
+    }
+    if (file->FileStatus == FileManager_FileIsOpen) {
+        FileManager_closeFile(file);
+    }
+    if (file->Ready) {
+        FileManager_unready(file);
+    }
+    while (Queue_available(&file->CommandQueue) > 0) {
+        Queue_readItem(&file->CommandQueue, &command);
+    }
+    while (Queue_available(&file->ReadQueue) > 0) {
+        Queue_readItem(&file->ReadQueue, &command);
+    }
+    Stream_moveReadPos(&file->WriteStream, Stream_available(&file->WriteStream));
+    Stream_moveReadPos(&file->ReadStream, Stream_available(&file->ReadStream));
+    file->CommandHeaderInProcess.Len = 0;
+    file->PendingHead                = 0;
+    file->PendingCount               = 0;
+    file->CancelCount                = 0;
+#if FILE_MANAGER_USE_ASYNC
+    file->AsyncWait                  = 0;
+    file->AsyncRead                  = 0;
+#endif
+    for (pFile = lastFile; pFile != FILE_MANAGER_NULL; pFile = pFile->Previous) {
+        if (pFile->Marker == file) {
+            pFile->Marker       = FILE_MANAGER_NULL;
+            pFile->CheckpointId = 0;                        ///// Record in removed marker is never written
+        }
+        if (pFile != file && pFile->CopySrc == file) {
+            if (pFile->CommandHeaderInProcess.Mode == FileManager_CopyMode) {
+                pFile->CommandHeaderInProcess.Len = 0;      ///// copy command in process can not read removed File
+            }
+            pFile->CopySrc = FILE_MANAGER_NULL;
+        }
+    }
+    FileManager_unlinkPath(file);
+    if (file->Next != FILE_MANAGER_NULL) {
+        file->Next->Previous = file->Previous;
+    }
+    else {
+        lastFile = file->Previous;
+    }
+    if (file->Previous != FILE_MANAGER_NULL) {
+        file->Previous->Next = file->Next;
+    }
+    file->Previous = FILE_MANAGER_NULL;
+    file->Next     = FILE_MANAGER_NULL;
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief find File by Path
+ * 
+ * @param path Path of File
+ * @return FileManager* FILE_MANAGER_NULL if no File has this Path
+ */
+FileManager* FileManager_find (const uint8_t* path) {
+    FileManager* pFile;
+    if (path == NULL) {
+        return FILE_MANAGER_NULL;
+    }
+    pFile = fileTable[FileManager_hashPath(path)];
+    while (pFile != FILE_MANAGER_NULL && strcmp((const char*)pFile->Path, (const char*)path) != 0) {
+        pFile = pFile->HashNext;
+    }
+    return pFile;
 }
 
 
+
 /**
  * @brief this Fuction return lastFile Value
  * 
@@ -418,6 +3250,25 @@ FileManager* FileManager_getLastFile (void) {
 
 
 
+/**
+ * @brief go to next File of ready-list, File which has no more work leave ready-list
+ *        (File with onIdle stay in ready-list)
+ */
+static FileManager* FileManager_nextReady (FileManager* file) {
+    FileManager* next = file->ReadyNext;
+    uint8_t      work = file->CommandHeaderInProcess.Len > 0 || Queue_available(&file->CommandQueue) > 0 || file->Callbacks.onIdle != NULL ||
+                        (file->FileStatus == FileManager_FileIsOpen && (file->Dirty || file->OtherPath));
+#if FILE_MANAGER_USE_ASYNC
+    work |= file->AsyncCount > 0 || file->AsyncWait || file->AsyncRead;
+#endif
+    if (!work) {
+        FileManager_unready(file);
+    }
+    return next;
+}
+
+
+
 //In usb    Mount -> 0
 //In sdCard Mount -> 1
 
@@ -427,51 +3278,55 @@ FileManager* FileManager_getLastFile (void) {
  * @return FileManager_Result 
  */
 FileManager_Result FileManager_handle (void) {
-    FileManager*              pFile = lastFile;
-    FileManager_CommandHeader readCommand;///after Read
-    char                      pathBuffer[MAX_PATH_LENGTH];
+    FileManager*              pFile = readyHead;
     Stream                    readTempStream;
-    FileManager_Result        fatFsResult;
+    FileManager_Result        fatFsResult = FileManager_OK;
+    FileManager_Result        opResult;
     uint16_t                  len = 0;
+    uint8_t                   sectors;
+    FileManager_Addr          pos;
+    uint8_t                   detected;
+    FileManager_Timestamp     start;
+#if FILE_MANAGER_USE_ASYNC
+    FileManager_Volume*       pVolume = lastVolume;
+    while (pVolume != FILE_MANAGER_VOLUME_NULL) {
+        if (pVolume->Driver->Poll != NULL) {
+            pVolume->Driver->Poll(pVolume, 0);             ///// reap completions of all Files of volume in one call
+        }
+        pVolume = pVolume->Previous;
+    }
+#endif
     while (pFile != FILE_MANAGER_NULL && pFile->InProcess != 1) {
-        if (fileManagerDriver->IsDetected()) {
+        detected = pFile->Volume->Driver->IsDetected(pFile->Volume);
+#if FILE_MANAGER_USE_ASYNC
+        if (detected && FileManager_asyncHandle(pFile)) {
+            pFile = FileManager_nextReady(pFile);
+            continue;
+        }
+#endif
+        if (detected) {
                 if (Queue_available(&pFile->CommandQueue) > 0 && pFile->CommandHeaderInProcess.Len == 0) {
-                    pFile->FirstTimeRun = 1;
-                    fatFsResult = fileManagerDriver->Mount(FileManager_ForceMount);
-                    Queue_readItem (&pFile->CommandQueue, &pFile->CommandHeaderInProcess);
-                    
-                    switch (pFile->CommandHeaderInProcess.Mode) {
-                        case FileManager_WriteMode :
-                        /*******************************************************************************************************************************/
-                          /*
-                          if (pFile->Callbacks.onGetAddress != NULL && pFile->UseForLogger == 1) {
-                              pFile->Callbacks.onGetAddress(pFile);
-                          }
-                        */
-                          /*******************************************************************************************************************************/
-                            if (pFile->CommandHeaderInProcess.DataType == FileManager_Const) {
-                                Stream_readBytes(&pFile->WriteStream, (uint8_t*)&pFile->ConstVal, sizeof(uint32_t));
-                            }
-                            break;
-                        case FileManager_ReadMode:
-                            memcpy (&readCommand, &pFile->CommandHeaderInProcess, sizeof(FileManager_CommandHeader));
-                            break;
-#if FILE_MANAGER_USE_FOR_LOGGER                        
-                        case FileManager_LoggerReadMode :
-                            memcpy (&readCommand, &pFile->CommandHeaderInProcess, sizeof(FileManager_CommandHeader));
-                            snprintf (pathBuffer, MAX_PATH_LENGTH - 1, FILE_MANAGER_PATH_FORMAT, ((FileManager_RecFrame*)pFile->Args1)->DeviceId,
-                               ((FileManager_RecFrame*)pFile->Args1)->Indicator, pFile->CommandHeaderInProcess.DT.Year, 
-                               pFile->CommandHeaderInProcess.DT.Month, pFile->CommandHeaderInProcess.DT.Day,
-                               pFile->CommandHeaderInProcess.DT.Hour, pFile->CommandHeaderInProcess.DT.Minute);
-                               fatFsResult = fileManagerDriver->Open(pFile, (uint8_t*)pathBuffer, FileManager_OpenAlways | FileManager_Write | FileManager_Read);
-                            break;
-#endif                        
-                   } 
+                    fatFsResult = FileManager_mount(pFile->Volume);
+                    if (FileManager_dequeue(pFile)) {
+                        fatFsResult = FileManager_beginCommand(pFile);
+                    }
                }
+#if FILE_MANAGER_USE_ASYNC
+               else if (pFile->AsyncWait) {
+                    pFile->AsyncWait = 0;                  ///// command was waiting for chunks in flight
+                    fatFsResult = FileManager_mount(pFile->Volume);
+                    if (!FileManager_dropCanceled(pFile)) {
+                        fatFsResult = FileManager_beginCommand(pFile);
+                    }
+               }
+#endif
 
-               if (pFile->CommandHeaderInProcess.Len > 0) {
-                 if (pFile->CommandHeaderInProcess.Mode != FileManager_LoggerReadMode) {
-                    fatFsResult = fileManagerDriver->Open(pFile, pFile->Path, FileManager_OpenAlways | FileManager_Write | FileManager_Read); ////Open
+               if (pFile->CommandHeaderInProcess.Len > 0 && !FileManager_alignHold(pFile)) {
+                 if (pFile->FileStatus == FileManager_FileIsOpen) {
+                    fatFsResult = FileManager_OK;
+                 }
+                 else if (pFile->CommandHeaderInProcess.Mode != FileManager_LoggerReadMode) {
+                    fatFsResult = pFile->Volume->Driver->Open(pFile, pFile->Path, FileManager_OpenAlways | FileManager_Write | FileManager_Read); ////Open
                  }
                  else if (pFile->CommandHeaderInProcess.Mode == FileManager_LoggerReadMode) {
                     pFile->CommandHeaderInProcess.Mode = FileManager_ReadMode;
@@ -479,17 +3334,19 @@ FileManager_Result FileManager_handle (void) {
                  
                  if (fatFsResult == FileManager_OK) {
                    pFile->FileStatus = FileManager_FileIsOpen;
-              /**/ if (fileManagerDriver->FileSize(pFile) == 0 && pFile->CommandHeaderInProcess.Mode == FileManager_WriteMode && pFile->UseForLogger) {
+              /**/ if (pFile->Volume->Driver->FileSize(pFile) == 0 && pFile->CommandHeaderInProcess.Mode == FileManager_WriteMode && pFile->UseForLogger) {
                       if (pFile->Callbacks.onCreateFile != 0) {
                           pFile->Callbacks.onCreateFile (pFile);
                       }
                    }
 //                   else {
                       if (pFile->CommandHeaderInProcess.Addr != END_OF_FILE) {
-                          fatFsResult = fileManagerDriver->Lseek (pFile, pFile->CommandHeaderInProcess.Addr);
+                          fatFsResult = pFile->Volume->Driver->Lseek (pFile, pFile->CommandHeaderInProcess.Addr);
                       } 
                       else {
-                          fatFsResult = fileManagerDriver->Lseek (pFile, fileManagerDriver->FileSize(pFile));
+                          pos         = pFile->Volume->Driver->FileSize(pFile);
+                          fatFsResult = pFile->Volume->Driver->Lseek (pFile, pos);
+                          FileManager_alignAt(pFile, pos);
                       }
 //                   
                  }
@@ -501,13 +3358,22 @@ FileManager_Result FileManager_handle (void) {
                 
                switch (pFile->CommandHeaderInProcess.Mode) {
                   case FileManager_WriteMode :
+                      if (pFile->Compress != NULL) {
+                          fatFsResult = FileManager_compressWrite(pFile);
+                          break;
+                      }
                       len = (pFile->CommandHeaderInProcess.Len > Stream_directAvailable(&pFile->WriteStream)) ? Stream_directAvailable(&pFile->WriteStream) : pFile->CommandHeaderInProcess.Len; 
+                      if (pFile->CommandHeaderInProcess.DataType == FileManager_Const) {
+                          len = pFile->CommandHeaderInProcess.Len > pFile->Config->MaxSS ? pFile->Config->MaxSS : pFile->CommandHeaderInProcess.Len;   ///// Data of Const is not in WriteStream
+                      }
                       pFile->Overflow = len > pFile->Config->MaxSS ? 1 : 0;
                       pFile->TempLen  = pFile->Overflow ? pFile->Config->MaxSS : len;
                 
                       switch (pFile->CommandHeaderInProcess.DataType) {
                           case FileManager_Const :
-                              fatFsResult = fileManagerDriver->Write (pFile, pFile->ConstVal, pFile->TempLen);
+                              start       = pFile->Volume->Driver->GetTimestamp();
+                              fatFsResult = pFile->Volume->Driver->Write (pFile, pFile->ConstVal, pFile->TempLen);
+                              FileManager_writeTime(pFile, start);
                               
                               if(pFile->PendingByte < pFile->TempLen - 1) {
                                 fatFsResult = FileManager_INVALID_DRIVE;
@@ -516,26 +3382,69 @@ FileManager_Result FileManager_handle (void) {
                                 pFile->CommandHeaderInProcess.Len  -= pFile->TempLen;
                                 pFile->CommandHeaderInProcess.Addr += pFile->TempLen;
                                 pFile->ConstVal                    += pFile->TempLen;
+                                FileManager_markDirty(pFile, pFile->TempLen);
                               }
                               break;
 
                           case FileManager_Var :
-                              fatFsResult = fileManagerDriver->Write(pFile, Stream_getReadPtr(&pFile->WriteStream), pFile->TempLen);
+                              if (pFile->Framing && !pFile->FrameOpen) {
+                                  fatFsResult = FileManager_frameBegin(pFile);
+                                  if (fatFsResult != FileManager_OK) {
+                                      break;
+                                  }
+                              }
+                              if (pFile->AlignRun > 0 && pFile->AlignPos >= 0 && pFile->CommandHeaderInProcess.Addr == END_OF_FILE &&
+                                  pFile->TempLen > (int32_t)(pFile->AlignRun - (uint32_t)(pFile->AlignPos % pFile->AlignRun))) {
+                                  pFile->TempLen = (int16_t)(pFile->AlignRun - (uint32_t)(pFile->AlignPos % pFile->AlignRun));   ///// end chunk on run boundary
+                              }
+                              start       = pFile->Volume->Driver->GetTimestamp();
+                              fatFsResult = pFile->Volume->Driver->Write(pFile, Stream_getReadPtr(&pFile->WriteStream), pFile->TempLen);
+                              FileManager_writeTime(pFile, start);
                               if (pFile->PendingByte < pFile->TempLen - 1) {
                                   fatFsResult = FileManager_INVALID_DRIVE;
                               }
                               if (fatFsResult == FileManager_OK) {
+                                  if (pFile->FrameOpen) {
+                                      pFile->FrameCrc = FileManagerCRC_update(pFile->FrameCrc, Stream_getReadPtr(&pFile->WriteStream), pFile->TempLen);
+                                  }
                                   Stream_moveReadPos (&pFile->WriteStream, pFile->TempLen);
                                   pFile->CommandHeaderInProcess.Len -= pFile->TempLen;                             
+                                  if (pFile->CommandHeaderInProcess.Addr != END_OF_FILE) {
+                                      pFile->CommandHeaderInProcess.Addr += pFile->TempLen;
+                                  }
+                                  else if (pFile->AlignPos >= 0) {
+                                      pFile->AlignPos += pFile->TempLen;
+                                  }
+                                  FileManager_markDirty(pFile, pFile->TempLen);
+                                  if (pFile->FrameOpen && pFile->CommandHeaderInProcess.Len < 1) {
+                                      fatFsResult = FileManager_frameEnd(pFile);
+                                  }
                               }
                               break;
                       }        
                       break;
                 
                    case FileManager_ReadMode :  
+                      if (pFile->Compress != NULL) {
+                          fatFsResult = FileManager_compressRead(pFile);
+                          if (fatFsResult == FileManager_INVALID_PARAMETER || (pFile->OtherPath && fatFsResult != FileManager_OK)) {
+                              pFile->CommandHeaderInProcess.Len = 0;  ///// Address after end of File, drop command
+                          }
+                          if (fatFsResult == FileManager_OK) {
+                              FileManager_deliverRead(pFile, &pFile->ReadCommand);
+                          }
+                          break;
+                      }
+                      if (pFile->Framing) {
+                          fatFsResult = FileManager_frameRead(pFile);
+                          if (fatFsResult == FileManager_OK) {
+                              FileManager_deliverRead(pFile, &pFile->ReadCommand);   ///// Data of corrupt Frame is not given to onRead
+                          }
+                          break;
+                      }
                       pFile->Overflow = pFile->CommandHeaderInProcess.Len > pFile->Config->MaxSS ? 1 : 0;
                       pFile->TempLen  = pFile->Overflow ? pFile->Config->MaxSS : pFile->CommandHeaderInProcess.Len;
-                      fatFsResult     = fileManagerDriver->Read (pFile, Stream_getWritePtr(&pFile->ReadStream), pFile->TempLen);
+                      fatFsResult     = pFile->Volume->Driver->Read (pFile, Stream_getWritePtr(&pFile->ReadStream), pFile->TempLen);
                       Stream_moveWritePos (&pFile->ReadStream, pFile->TempLen);
                       if (pFile->PendingByte < pFile->TempLen - 1) {
                           fatFsResult = FileManager_INVALID_DRIVE;
@@ -543,29 +3452,94 @@ FileManager_Result FileManager_handle (void) {
                       
                       if (fatFsResult == FileManager_OK) {
                           pFile->CommandHeaderInProcess.Len -= pFile->TempLen;
+                          if (pFile->CommandHeaderInProcess.Len < 1) {
+                              FileManager_swapRead(pFile);
+                          }
                           if (pFile->Callbacks.onRead != NULL && pFile->CommandHeaderInProcess.Len < 1) {
-                              Stream_lockRead (&pFile->ReadStream, &readTempStream, readCommand.Len);
-                              pFile->Callbacks.onRead (pFile, &readTempStream, &readCommand);
+                              Stream_lockRead (&pFile->ReadStream, &readTempStream, pFile->ReadCommand.Len);
+                              pFile->Callbacks.onRead (pFile, &readTempStream, &pFile->ReadCommand);
                               Stream_unlockRead (&pFile->ReadStream, &readTempStream);
                           }
                           pFile->CommandHeaderInProcess.Addr += pFile->TempLen;
                       }
-                      break;                    
+                      break;
+
+                   case FileManager_FillMode :
+                      FileManager_preparePattern(pFile->FillPattern);
+                      pos     = pFile->CommandHeaderInProcess.Addr != END_OF_FILE ? pFile->CommandHeaderInProcess.Addr : (FileManager_Addr)pFile->Volume->Driver->FileSize(pFile);
+                      sectors = 0;
+                      while (pFile->CommandHeaderInProcess.Len > 0 && sectors < FILE_MANAGER_FILL_SECTORS && fatFsResult == FileManager_OK) {
+                          pFile->TempLen = FileManager_fillChunkLen(pFile, pos, pFile->CommandHeaderInProcess.Len);
+                          fatFsResult    = pFile->Volume->Driver->Write(pFile, fillBuffer, pFile->TempLen);
+                          if (pFile->PendingByte < (uint32_t)pFile->TempLen) {
+                              fatFsResult = FileManager_INVALID_DRIVE;
+                          }
+                          if (fatFsResult == FileManager_OK) {
+                              pFile->CommandHeaderInProcess.Len -= pFile->TempLen;
+                              if (pFile->CommandHeaderInProcess.Addr != END_OF_FILE) {
+                                  pFile->CommandHeaderInProcess.Addr += pFile->TempLen;
+                              }
+                              pos += pFile->TempLen;
+                              FileManager_markDirty(pFile, pFile->TempLen);
+                          }
+                          sectors++;
+                      }
+                      break;
+
+                   case FileManager_CopyMode :
+                      fatFsResult = FileManager_copyPass(pFile);
+                      break;
+
+                   case FileManager_MapReadMode :
+                      fatFsResult = FileManager_mapRead(pFile);
+                      break;
+
+                   case FileManager_StreamReadMode :
+                      fatFsResult = FileManager_streamRead(pFile);
+                      break;
+
+                   case FileManager_TruncateMode :
+                      fatFsResult = pFile->Volume->Driver->Truncate != NULL ? pFile->Volume->Driver->Truncate(pFile) : FileManager_NOT_ENABLED;
+                      if (fatFsResult == FileManager_OK) {
+                          FileManager_markDirty(pFile, 0);
+                      }
+                      pFile->CommandHeaderInProcess.Len = 0;
+                      break;
+
+                   case FileManager_SyncMode :
+                      if (pFile->Compress != NULL) {
+                          FileManager_emitBlock(pFile);
+                      }
+                      fatFsResult = FileManager_syncFile(pFile);
+                      pFile->CommandHeaderInProcess.Len = 0;
+                      break;
+               }
+               if (fatFsResult == FileManager_DISK_ERR || fatFsResult == FileManager_NOT_READY) {
+                   pFile->Volume->Mounted = 0;                ///// Mount again before next command
                }
-               fatFsResult = fileManagerDriver->Close(pFile);
-               if (fatFsResult == FileManager_OK) {
-                  pFile->FileStatus = FileManager_FileIsClose;
+               opResult    = fatFsResult;
+               fatFsResult = FileManager_commit(pFile, pFile->CommandHeaderInProcess.Len < 1);
+               if (pFile->Callbacks.onComplete != NULL && pFile->CommandHeaderInProcess.Len < 1) {
+                   pFile->Callbacks.onComplete(pFile, pFile->CommandHeaderInProcess.Mode == FileManager_ReadMode ? &pFile->ReadCommand : &pFile->CommandHeaderInProcess,
+                                               opResult != FileManager_OK ? opResult : fatFsResult);
                }
              }
+             else if (pFile->FileStatus == FileManager_FileIsOpen && pFile->CommandHeaderInProcess.Len < 1) {
+               fatFsResult = FileManager_commit(pFile, 1);                ///// command is done (held append keep Len > 0, it is not Synced/Closed)
+             }
+             if (pFile->Callbacks.onIdle != NULL && pFile->CommandHeaderInProcess.Len < 1 && Queue_available(&pFile->CommandQueue) == 0) {
+               pFile->Callbacks.onIdle(pFile);
+             }
            }
            else {
-              //fatFsResult = fileManagerDriver->UnMount();
+              //fatFsResult = pFile->Volume->Driver->UnMount();
+              pFile->Volume->Mounted = 0;
               if (pFile->Callbacks.onNotDetect != NULL) {
                   pFile->Callbacks.onNotDetect();
               }
             fatFsResult = FileManager_DISK_ERR;    
           }
-          pFile = pFile->Previous;    
+          pFile = FileManager_nextReady(pFile);
       }
     return fatFsResult;
 }
@@ -608,8 +3582,9 @@ void* FileManager_getArgs (FileManager* file) {
  * @param len Length of Data
  */
 void File_writeHeader (FileManager* file, uint8_t* data, uint16_t len) {
-    fileManagerDriver->Lseek(file, 0);
-    fileManagerDriver->Write(file, data, len);
+    file->Volume->Driver->Lseek(file, 0);
+    file->Volume->Driver->Write(file, data, len);
+    FileManager_markDirty(file, len);
 }
 
 /*****************************************************************************/
@@ -621,7 +3596,7 @@ void File_writeHeader (FileManager* file, uint8_t* data, uint16_t len) {
  * @param addr Address in File user want write there
  * @return FileManager_Result 
  */
-FileManager_Result File_writeUInt8Blocking (FileManager* file, uint8_t val, int32_t addr) {
+FileManager_Result File_writeUInt8Blocking (FileManager* file, uint8_t val, FileManager_Addr addr) {
     return File_writeBlocking (file, addr, (uint8_t*)&val, sizeof(val));
 }
 
@@ -632,7 +3607,7 @@ FileManager_Result File_writeUInt8Blocking (FileManager* file, uint8_t val, int3
  * @param addr Address in File user want Read from that
  * @return uint8_t 
  */
-uint8_t File_readUInt8Blocking (FileManager* file, int32_t addr) {
+uint8_t File_readUInt8Blocking (FileManager* file, FileManager_Addr addr) {
     uint8_t val = 0;
     File_readBlocking (file, addr, (uint8_t*)&val, sizeof(val));
     return val;
@@ -648,7 +3623,7 @@ uint8_t File_readUInt8Blocking (FileManager* file, int32_t addr) {
  * @param addr Address in File user want write there
  * @return FileManager_Result 
  */
-FileManager_Result File_writeUInt16Blocking (FileManager* file, uint16_t val, int32_t addr) {
+FileManager_Result File_writeUInt16Blocking (FileManager* file, uint16_t val, FileManager_Addr addr) {
     return File_writeBlocking (file, addr, (uint8_t*)&val, sizeof(val));
 }
 
@@ -659,7 +3634,7 @@ FileManager_Result File_writeUInt16Blocking (FileManager* file, uint16_t val, in
  * @param addr Address in File user want Read from that
  * @return uint16_t Value 
  */
-uint16_t File_readUInt16Blocking (FileManager* file, int32_t addr) {
+uint16_t File_readUInt16Blocking (FileManager* file, FileManager_Addr addr) {
     uint16_t val = 0;
     File_readBlocking (file, addr, (uint8_t*)&val, sizeof(val));
     return val;
@@ -675,7 +3650,7 @@ uint16_t File_readUInt16Blocking (FileManager* file, int32_t addr) {
  * @param addr Address in File user want write there
  * @return FileManager_Result 
  */
-FileManager_Result File_writeUInt32Blocking (FileManager* file, uint32_t val, int32_t addr) {
+FileManager_Result File_writeUInt32Blocking (FileManager* file, uint32_t val, FileManager_Addr addr) {
     return File_writeBlocking (file, addr, (uint8_t*)&val, sizeof(val));
 }
 
@@ -686,7 +3661,7 @@ FileManager_Result File_writeUInt32Blocking (FileManager* file, uint32_t val, in
  * @param addr Address in File user want Read from that
  * @return uint32_t Value 
  */
-uint32_t File_readUInt32Blocking (FileManager* file, int32_t addr) {
+uint32_t File_readUInt32Blocking (FileManager* file, FileManager_Addr addr) {
     uint32_t val = 0;
     File_readBlocking(file, addr, (uint8_t*)&val, sizeof(val));
     return val;
@@ -701,7 +3676,7 @@ uint32_t File_readUInt32Blocking (FileManager* file, int32_t addr) {
  * @param addr Address in File user want write there
  * @return FileManager_Result 
  */
-FileManager_Result File_writeUInt64Blocking (FileManager* file, uint64_t val, int32_t addr) {
+FileManager_Result File_writeUInt64Blocking (FileManager* file, uint64_t val, FileManager_Addr addr) {
     return File_writeBlocking(file, addr, (uint8_t*)&val, sizeof(val));
 }
 
@@ -713,13 +3688,218 @@ FileManager_Result File_writeUInt64Blocking (FileManager* file, uint64_t val, in
  * @param addr Address in File user want Read from that
  * @return uint64_t Value 
  */
-uint64_t File_readUInt64Blocking (FileManager* file, int32_t addr) {
+uint64_t File_readUInt64Blocking (FileManager* file, FileManager_Addr addr) {
     uint64_t val = 0;
     File_readBlocking (file, addr, (uint8_t*)&val, sizeof(val));
     return val;
 }
 
 
+
+/**
+ * @brief element size to swap for Byte order of File, 1 when endian is same as host
+ */
+static uint8_t FileManager_swapSize (uint8_t size, FileManager_Endian endian) {
+    return endian != FileManager_NativeEndian && endian != FILE_MANAGER_HOST_ENDIAN ? size : 1;
+}
+
+/**
+ * @brief check element size and count of array, len get Bytes of array
+ */
+static uint8_t FileManager_arrayLen (int32_t count, uint8_t size, int32_t* len) {
+    if ((size != 1 && size != 2 && size != 4 && size != 8) || count < 1 || count > INT32_MAX / size) {
+        return 0;
+    }
+    *len = count * size;
+    return 1;
+}
+
+
+
+/**
+ * @brief NonBlocking write of array of count elements, each element is size Bytes (1, 2, 4, 8),
+ *        elements are written in endian Byte order of File, for other order than host
+ *        they are swapped while copied into WriteStream (no extra Buffer of user)
+ * 
+ * @param file   Address of FileManager
+ * @param addr   Address in File user want write there
+ * @param data   Address of elements
+ * @param count  number of elements
+ * @param size   Bytes of one element
+ * @param endian Byte order of File, FileManager_NativeEndian write host order
+ * @return FileManager_Result FileManager_NOT_ENOUGH_CORE if WriteStream has no space for array (host and swapped order), nothing is queued then,
+ *         FileManager_NOT_ENABLED if addr is not END_OF_FILE on compressed File
+ */
+FileManager_Result File_writeArray (FileManager* file, FileManager_Addr addr, const void* data, int32_t count, uint8_t size, FileManager_Endian endian) {
+    FileManager_CommandHeader cacheHeader;
+    uint8_t                   swap = FileManager_swapSize(size, endian);
+    int32_t                   len;
+    int32_t                   done;
+    int32_t                   tempLen;
+    if (!FileManager_arrayLen(count, size, &len)) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    if (swap == 1) {
+        return File_write(file, addr, (uint8_t*)data, len, FileManager_Var);
+    }
+    if (file->Compress != NULL && addr != END_OF_FILE) {
+        return FileManager_NOT_ENABLED;                     ///// compressed File only append
+    }
+    if (Stream_space(&file->WriteStream) < len || Queue_space(&file->CommandQueue) == 0 || !FileManager_pendingAdd(file, addr, len, file->WriteTotal, file->LastId + 1)) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
+    cacheHeader.Addr     = addr;
+    cacheHeader.Len      = len;
+    cacheHeader.DataType = FileManager_Var;
+    cacheHeader.Mode     = FileManager_WriteMode;
+    FileManager_enqueue(file, &cacheHeader);
+    for (done = 0; done < len; done += tempLen) {
+        tempLen = len - done > (int32_t)sizeof(swapBuffer) ? (int32_t)sizeof(swapBuffer) : len - done;
+        FileManagerSwap_copy((uint8_t*)swapBuffer, (const uint8_t*)data + done, tempLen / size, swap);
+        FileManager_streamWrite(file, (uint8_t*)swapBuffer, tempLen);
+    }
+    return FileManager_OK;
+}
+
+/**
+ * @brief Blocking write of array (see File_writeArray), swapped elements go through static swap Buffer
+ * 
+ * @param file   Address of FileManager
+ * @param addr   Address in File user want write there
+ * @param data   Address of elements
+ * @param count  number of elements
+ * @param size   Bytes of one element
+ * @param endian Byte order of File
+ * @return FileManager_Result 
+ */
+FileManager_Result File_writeArrayBlocking (FileManager* file, FileManager_Addr addr, const void* data, int32_t count, uint8_t size, FileManager_Endian endian) {
+    int32_t len;
+    if (!FileManager_arrayLen(count, size, &len)) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    return FileManager_writeBlocking(file, addr, (const uint8_t*)data, len, FileManager_swapSize(size, endian));
+}
+
+/**
+ * @brief NonBlocking read of array, elements are swapped into host order in ReadStream before onRead
+ * 
+ * @param file   Address of FileManager
+ * @param addr   Address in File user want Read from that
+ * @param count  number of elements
+ * @param size   Bytes of one element
+ * @param endian Byte order of File
+ * @return FileManager_Result 
+ */
+FileManager_Result File_readArray (FileManager* file, FileManager_Addr addr, int32_t count, uint8_t size, FileManager_Endian endian) {
+    FileManager_CommandHeader cacheHeader;
+    uint8_t                   swap = FileManager_swapSize(size, endian);
+    int32_t                   len;
+    if (!FileManager_arrayLen(count, size, &len)) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    memset(&cacheHeader.DT, 0, sizeof(cacheHeader.DT));
+    cacheHeader.Addr     = addr;
+    cacheHeader.Len      = len;
+    cacheHeader.DataType = swap > 1 ? swap : FileManager_Var;   ///// FileManager_Swap16/32/64
+    cacheHeader.Mode     = FileManager_ReadMode;
+    return FileManager_enqueue(file, &cacheHeader);
+}
+
+/**
+ * @brief Blocking read of array into data, elements are swapped in place into host order
+ * 
+ * @param file   Address of FileManager
+ * @param addr   Address in File user want Read from that
+ * @param data   Address of elements
+ * @param count  number of elements
+ * @param size   Bytes of one element
+ * @param endian Byte order of File
+ * @return FileManager_Result 
+ */
+FileManager_Result File_readArrayBlocking (FileManager* file, FileManager_Addr addr, void* data, int32_t count, uint8_t size, FileManager_Endian endian) {
+    FileManager_Result result;
+    int32_t            len;
+    if (!FileManager_arrayLen(count, size, &len)) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    result = File_readBlocking(file, addr, (uint8_t*)data, len);
+    if (result == FileManager_OK) {
+        FileManagerSwap_copy((uint8_t*)data, (const uint8_t*)data, count, FileManager_swapSize(size, endian));
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief typed arrays of File_writeArray/File_readArray (Blocking and NonBlocking)
+ */
+FileManager_Result File_writeArrayU16 (FileManager* file, FileManager_Addr addr, const uint16_t* data, int32_t count, FileManager_Endian endian) {
+    return File_writeArray(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_writeArrayU32 (FileManager* file, FileManager_Addr addr, const uint32_t* data, int32_t count, FileManager_Endian endian) {
+    return File_writeArray(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_writeArrayU64 (FileManager* file, FileManager_Addr addr, const uint64_t* data, int32_t count, FileManager_Endian endian) {
+    return File_writeArray(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_writeArrayF32 (FileManager* file, FileManager_Addr addr, const float* data, int32_t count, FileManager_Endian endian) {
+    return File_writeArray(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_writeArrayU16Blocking (FileManager* file, FileManager_Addr addr, const uint16_t* data, int32_t count, FileManager_Endian endian) {
+    return File_writeArrayBlocking(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_writeArrayU32Blocking (FileManager* file, FileManager_Addr addr, const uint32_t* data, int32_t count, FileManager_Endian endian) {
+    return File_writeArrayBlocking(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_writeArrayU64Blocking (FileManager* file, FileManager_Addr addr, const uint64_t* data, int32_t count, FileManager_Endian endian) {
+    return File_writeArrayBlocking(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_writeArrayF32Blocking (FileManager* file, FileManager_Addr addr, const float* data, int32_t count, FileManager_Endian endian) {
+    return File_writeArrayBlocking(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_readArrayU16 (FileManager* file, FileManager_Addr addr, int32_t count, FileManager_Endian endian) {
+    return File_readArray(file, addr, count, sizeof(uint16_t), endian);
+}
+
+FileManager_Result File_readArrayU32 (FileManager* file, FileManager_Addr addr, int32_t count, FileManager_Endian endian) {
+    return File_readArray(file, addr, count, sizeof(uint32_t), endian);
+}
+
+FileManager_Result File_readArrayU64 (FileManager* file, FileManager_Addr addr, int32_t count, FileManager_Endian endian) {
+    return File_readArray(file, addr, count, sizeof(uint64_t), endian);
+}
+
+FileManager_Result File_readArrayF32 (FileManager* file, FileManager_Addr addr, int32_t count, FileManager_Endian endian) {
+    return File_readArray(file, addr, count, sizeof(float), endian);
+}
+
+FileManager_Result File_readArrayU16Blocking (FileManager* file, FileManager_Addr addr, uint16_t* data, int32_t count, FileManager_Endian endian) {
+    return File_readArrayBlocking(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_readArrayU32Blocking (FileManager* file, FileManager_Addr addr, uint32_t* data, int32_t count, FileManager_Endian endian) {
+    return File_readArrayBlocking(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_readArrayU64Blocking (FileManager* file, FileManager_Addr addr, uint64_t* data, int32_t count, FileManager_Endian endian) {
+    return File_readArrayBlocking(file, addr, data, count, sizeof(*data), endian);
+}
+
+FileManager_Result File_readArrayF32Blocking (FileManager* file, FileManager_Addr addr, float* data, int32_t count, FileManager_Endian endian) {
+    return File_readArrayBlocking(file, addr, data, count, sizeof(*data), endian);
+}
+
+
 /***************************** CallBack Function **************************/
 void File_onRead       (FileManager* file, FileManager_ReadCallbackFn cb) {
     file->Callbacks.onRead = cb;
@@ -741,6 +3921,27 @@ void File_onGetAddress (FileManager* file, FileManager_getAddressFn cb) {
     file->Callbacks.onGetAddress = cb;
 }
 
+void File_onIdle       (FileManager* file, FileManager_idleCallbackFn cb) {
+    file->Callbacks.onIdle = cb;
+    FileManager_makeReady(file);                            ///// File with onIdle stay in ready-list
+}
+
+void File_onError      (FileManager* file, FileManager_errorCallbackFn cb) {
+    file->Callbacks.onError = cb;
+}
+
+void File_onComplete   (FileManager* file, FileManager_completeCallbackFn cb) {
+    file->Callbacks.onComplete = cb;
+}
+
+void File_onReadChunk  (FileManager* file, FileManager_readChunkCallbackFn cb) {
+    file->Callbacks.onReadChunk = cb;
+}
+
+void File_onCapture    (FileManager* file, FileManager_captureCallbackFn cb) {
+    file->Callbacks.onCapture = cb;
+}
+
 
 
 /*********************************************************************************/
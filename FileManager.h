@@ -13,7 +13,7 @@
 #ifndef _FILE_MANAGER_H_
 #define _FILE_MANAGER_H_
 
-#ifdef _cplusplus
+#ifdef __cplusplus
 extern "C" {
 #endif
 
@@ -24,18 +24,50 @@ extern "C" {
 #include "StreamBuffer.h"
 #include "DateTime.h"
 
-#define   FILE_MANAGER_TIMEOUT            1000
+#ifndef   FILE_MANAGER_TIMEOUT
+#define   FILE_MANAGER_TIMEOUT            1000         ///// ms without progress before Blocking functions return FileManager_TIMEOUT
+#endif
 //#define   FILE_CHECK_ENABLE             0
 #define   FILE_MANAGER_USE_FOR_LOGGER     1
+#ifndef   FILE_MANAGER_USE_ASYNC
+#define   FILE_MANAGER_USE_ASYNC          0            ///// 1 -> use Submit/Poll of driver (host build with io_uring)
+#endif
+#define   FILE_MANAGER_ASYNC_DEPTH        8            ///// max chunks of one File in flight
+#define   FILE_MANAGER_ASYNC_SECTORS      8            ///// max sectors in one async chunk
+#define   FILE_MANAGER_ASYNC_RETRIES      3            ///// failed chunk is submitted again before its Data is dropped
+#define   FILE_MANAGER_FILE_TABLE_SIZE    32           ///// Buckets of Path lookup table (power of 2)
+#ifndef   FILE_MANAGER_USE_64BIT_ADDR
+#define   FILE_MANAGER_USE_64BIT_ADDR     1            ///// 0 -> int32_t Addresses of old versions (Files < 2GB)
+#endif
 #define   END_OF_FILE                     -1
 /*New*/
 #define   MAX_PATH_LENGTH                 50
+#define   FILE_MANAGER_MAP_WINDOW         (1UL << 20)  ///// max Bytes of mapped File given to onRead in one call
 #define   FILE_MANAGER_PATH_FORMAT       "%u-%s-%02u%02u%02u-%02u%02u.txt"
 /*End*/
 
-#define   MAXIMUM_ERASE_BUFFER_SIZE        64           ///// if u use big Number it possible Stack OverFlow
+#define   FILE_MANAGER_FILL_BUFFER_SIZE    512          ///// static pattern buffer for File_fill, keep it >= MaxSS for sector-aligned writes
+#define   MAXIMUM_ERASE_BUFFER_SIZE        64           ///// deprecated, File_fill use FILE_MANAGER_FILL_BUFFER_SIZE, kept for old code
+#define   FILE_MANAGER_FILL_SECTORS        8            ///// max sectors File_fill writes in one FileManager_handle pass
+#define   FILE_MANAGER_COPY_BUFFER_SIZE    2048         ///// each of two static File_copy buffers, keep it multiple of MaxSS
+#define   FILE_MANAGER_COPY_BLOCKS         4            ///// max buffers File_copy writes in one FileManager_handle pass
+#define   FILE_MANAGER_CANCEL_DEPTH        8            ///// max canceled commands of one File which are still in CommandQueue
+#ifndef   FILE_MANAGER_STALL_TIME
+#define   FILE_MANAGER_STALL_TIME          100          ///// ms, driver Write which take longer is counted as stall
+#endif
+#define   FILE_MANAGER_ALIGN_DISCOVER      -1           ///// File_setAlignment get device Address of File from driver Physical
+#define   FILE_MANAGER_SWAP_BUFFER_SIZE    512          ///// static buffer of array writes with swapped Bytes, multiple of 8
+#define   FILE_MANAGER_CHECKPOINT_SLOTS    4            ///// checkpoint Records are written round robin in these slots of marker File
+#define   FILE_MANAGER_RECOVER_BUFFER_SIZE 256          ///// stack buffer of File_recover to verify Frames after checkpoint
 
 typedef   void      FileManager_Fil;
+#if FILE_MANAGER_USE_64BIT_ADDR
+typedef   int64_t   FileManager_Addr;                   ///// Address in File
+typedef   uint64_t  FileManager_Size;                   ///// Size of File
+#else
+typedef   int32_t   FileManager_Addr;
+typedef   uint32_t  FileManager_Size;
+#endif
 typedef   uint32_t  FileManager_Timestamp;
 
 
@@ -59,7 +91,9 @@ typedef enum {
     FileManager_LOCKED,              /* (16) The operation is rejected according to the file sharing policy */
     FileManager_NOT_ENOUGH_CORE,     /* (17) LFN working buffer could not be allocated */
     FileManager_TOO_MANY_OPEN_FILES, /* (18) Number of open files > _FS_LOCK */
-    FileManager_INVALID_PARAMETER    /* (19) Given parameter is invalid */
+    FileManager_INVALID_PARAMETER,   /* (19) Given parameter is invalid */
+    FileManager_CRC_ERR,             /* (20) Frame Header or CRC of read Data is not valid */
+    FileManager_EOF,                 /* (21) Blocking read reached end of File before all Bytes */
 } FileManager_Result;
 
 
@@ -72,7 +106,23 @@ typedef enum {
 typedef enum {
     FileManager_Const            = 0,
     FileManager_Var              = 1,
-} FileManager_Type;              
+    FileManager_Swap16           = 2,     ///// read command: swap Bytes of each 16bit element before onRead
+    FileManager_Swap32           = 4,
+    FileManager_Swap64           = 8,
+} FileManager_Type;
+
+
+typedef enum {
+    FileManager_NativeEndian     = 0x00,
+    FileManager_LittleEndian     = 0x01,
+    FileManager_BigEndian        = 0x02,
+} FileManager_Endian;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define   FILE_MANAGER_HOST_ENDIAN        FileManager_BigEndian
+#else
+#define   FILE_MANAGER_HOST_ENDIAN        FileManager_LittleEndian
+#endif              
                                  
                                  
 typedef enum {                   
@@ -80,7 +130,23 @@ typedef enum {
     FileManager_ReadMode         = 0x01,
     FileManager_WriteHeaderMode  = 0x02,
     FileManager_LoggerReadMode   = 0x03,
-} FileManager_Mode;              
+    FileManager_FillMode         = 0x04,
+    FileManager_SyncMode         = 0x05,
+    FileManager_MapReadMode      = 0x06,
+    FileManager_StreamReadMode   = 0x07,
+    FileManager_CopyMode         = 0x08,
+    FileManager_TruncateMode     = 0x09,
+} FileManager_Mode;
+
+
+
+typedef enum {
+    FileManager_SyncOnClose      = 0x00,  ///// Close File after every chunk (default)
+    FileManager_SyncEveryBytes   = 0x01,  ///// keep File open, Sync when threshold Bytes are written
+    FileManager_SyncEveryTime    = 0x02,  ///// keep File open, Sync when oldest unsynced Byte is threshold ms old
+    FileManager_SyncEveryCommand = 0x03,  ///// keep File open, Sync after each command
+    FileManager_SyncExplicit     = 0x04,  ///// keep File open, Sync only on File_flush
+} FileManager_SyncPolicy;              
                                  
                                  
                                  
@@ -102,13 +168,129 @@ typedef struct {
 
 
 
+typedef struct {
+    uint32_t  BytesWritten;
+    uint32_t  SyncCount;
+    uint32_t  LastCommitLatency;       ///// ms between first unsynced Byte and end of Sync
+    uint32_t  MaxCommitLatency;
+    uint32_t  TotalCommitLatency;
+    uint32_t  DroppedBytes;            ///// Bytes of canceled or replaced writes which are not written
+    uint32_t  Stalls;                  ///// driver Write calls longer than FILE_MANAGER_STALL_TIME
+    uint32_t  MaxWriteTime;            ///// ms of longest driver Write
+    uint32_t  HoldTimeouts;            ///// held appends which are written before run was full
+} FileManager_Stats;
+
+
+
+#define   FILE_MANAGER_BLOCK_MAGIC        0x4C5A        ///// "LZ"
+#define   FILE_MANAGER_FRAME_MAGIC        0x4643        ///// "CF"
+#define   FILE_MANAGER_CHECKPOINT_MAGIC   0x5043        ///// "CP"
+
+
+/**
+ * @brief Header of each Frame (one write command) in File, CRC32C of Data come after Data
+ */
+typedef struct {
+    uint16_t  Magic;
+    uint16_t  Reserved;
+    int32_t   Len;
+} FileManager_FrameHeader;
+
+
+/**
+ * @brief checkpoint Record in marker File, End is durable end of valid Data of File when Record is written
+ */
+typedef struct {
+    uint16_t          Magic;
+    uint16_t          Reserved;
+    uint32_t          Seq;          ///// newest valid Record win
+    uint32_t          Crc;          ///// CRC32C of Record (Crc = 0)
+    uint32_t          Reserved2;
+    FileManager_Addr  End;          ///// Frame boundary on framed File
+} FileManager_Checkpoint;
+
+typedef enum {
+    FileManager_BlockCoded       = 0x00,
+    FileManager_BlockStored      = 0x01,              ///// Block not shrink, raw Data stored
+} FileManager_BlockFlags;
+
+
+/**
+ * @brief Header of each compressed Block in File
+ */
+typedef struct {
+    uint16_t  Magic;
+    uint16_t  RawLen;
+    uint16_t  CodedLen;
+    uint16_t  Flags;
+} FileManager_BlockHeader;
+
+
+typedef struct {
+    FileManager_Addr Logical;            ///// Address of first raw Byte of Block
+    FileManager_Addr Physical;           ///// Address of Block Header in File
+} FileManager_BlockIndex;
+
+
+/**
+ * @brief Compression stage between WriteStream and driver Write
+ */
+typedef struct {
+    uint8_t*                Block;       ///// raw Block, write Data collect here, read Block decode here
+    uint8_t*                Coded;       ///// Header + compressed Block
+    FileManager_BlockIndex* Index;
+    uint16_t                BlockLen;
+    uint16_t                CodedLen;    ///// at least BlockLen + sizeof(FileManager_BlockHeader)
+    uint16_t                IndexLen;
+    uint16_t                IndexCount;
+    uint16_t                Fill;        ///// raw Bytes in Block wait for compress
+    uint16_t                CachedLen;   ///// raw Bytes of decoded Block
+    FileManager_Addr        CachedStart; ///// Logical Address of decoded Block, -1 -> no Block
+    FileManager_Addr        LogicalEnd;
+    FileManager_Addr        PhysicalEnd;
+    uint32_t                RawBytes;
+    uint32_t                CodedBytes;  ///// Bytes written into SdCard (with Headers)
+} FileManager_Compress;
+
+
+
+/**
+ * @brief one chunk in flight on async driver, driver set Result and Done on completion
+ */
+typedef struct {
+    void*            Data;
+    FileManager_Addr Addr;
+    int32_t          Len;
+    int32_t          Result;             ///// transferred Bytes, negative -> error
+    uint8_t          Mode;               ///// FileManager_WriteMode or FileManager_ReadMode
+    uint8_t          Done;
+    uint8_t          Last;               ///// last chunk of command
+    uint8_t          Retries;
+    uint32_t         Id;                 ///// Id of command, onComplete of last chunk get it
+} FileManager_AsyncOp;
+
+
+
+/**
+ * @brief write command whose Data is still in WriteStream, File_readBlocking take Bytes of it instead of card Data
+ */
+typedef struct {
+    FileManager_Addr Addr;               ///// END_OF_FILE -> append
+    int32_t          Len;
+    uint32_t         Offset;             ///// place of first Byte in WriteStream (WriteTotal when command is queued)
+    uint32_t         Id;                 ///// Id of command (last one when appends are joined)
+} FileManager_Pending;
+
+
+
 /**
  * @brief 
  */
 typedef struct {    
     DateTime_X             DT;
-    int32_t                Addr;
+    FileManager_Addr       Addr;
     int32_t                Len;
+    uint32_t               Id;           ///// given when command is queued (File_getLastId), used by File_cancel
     uint8_t                DataType;
     uint8_t                Mode;
 } FileManager_CommandHeader;
@@ -134,6 +316,8 @@ typedef enum {
 /****PreDefined Struct****/
 struct          _FileManager;
 typedef struct  _FileManager  FileManager;
+struct          _FileManager_Volume;
+typedef struct  _FileManager_Volume  FileManager_Volume;
 
 
 typedef void (*FileManager_ReadCallbackFn)       (FileManager* file, Stream* stream, FileManager_CommandHeader* command);
@@ -141,6 +325,12 @@ typedef void (*FileManager_noDetectSDCallbackFn)     (void);
 typedef void (*FileManager_createFileCallbackFn) (FileManager* file);
 //typedef void (*FileManager_changePathCallbackFn) (FileManager* file);
 typedef void (*FileManager_getAddressFn)         (FileManager* file);
+typedef void (*FileManager_idleCallbackFn)       (FileManager* file);
+typedef void (*FileManager_errorCallbackFn)      (FileManager* file, FileManager_Result result, FileManager_Addr addr);
+typedef void (*FileManager_completeCallbackFn)   (FileManager* file, FileManager_CommandHeader* command, FileManager_Result result);
+typedef void (*FileManager_readChunkCallbackFn)  (FileManager* file, Stream* stream, FileManager_Addr addr, int32_t len, int32_t remain);
+typedef void (*FileManager_captureCallbackFn)    (FileManager* file, const FileManager_CommandHeader* command);
+typedef void (*FileManager_yieldFn)              (void* args);
 
 
 
@@ -149,30 +339,86 @@ typedef struct {
     FileManager_noDetectSDCallbackFn  onNotDetect;
     FileManager_createFileCallbackFn  onCreateFile;
     FileManager_getAddressFn          onGetAddress;
+    FileManager_idleCallbackFn        onIdle;   //This callbacks occur in FileManager_handle when File has no command  
+    FileManager_errorCallbackFn       onError;  //This callbacks occur when read Frame is corrupt
+    FileManager_completeCallbackFn    onComplete; //This callbacks occur when one queued command is finished (commands of File finish in order)
+    FileManager_readChunkCallbackFn   onReadChunk; //This callbacks occur for each chunk of File_readStream, consumer read Bytes out of stream when it can
+    FileManager_captureCallbackFn     onCapture;   //This callbacks occur when each command is queued
 } FileManager_Callbacks;
 
 
 struct _FileManager {
     struct _FileManager*      Previous;
+    struct _FileManager*      Next;
+    struct _FileManager*      HashNext;                         /*next File in same Bucket of Path table*/
+    struct _FileManager*      ReadyNext;                        /*next File which has work for FileManager_handle*/
+    struct _FileManager*      ReadyPrev;                        /*File before it in ready-list, remove is O(1)*/
     FileManager_Fil*          Context;  
     const FileManager_Config* Config;
+    FileManager_Volume*       Volume;
     uint8_t*                  Path;
     uint8_t*                  ConstVal;
     uint32_t                  PendingByte;
+    uint8_t                   FillPattern;
+    struct _FileManager*      CopySrc;                          /*source File of copy command in process*/
+    FileManager_Addr          CopyAddr;                         /*next Address of CopySrc*/
     FileManager_Callbacks     Callbacks;
     FileManager_CommandHeader CommandHeaderInProcess;               
+    FileManager_CommandHeader ReadCommand;                      /*read command for onRead*/
     Queue                     CommandQueue;            
     Queue                     ReadQueue;               
     Stream                    WriteStream;             
     Stream                    ReadStream;
     Stream                    TempStream;
     Stream                    HeaderStream;
+    FileManager_Compress*     Compress;     /*NULL -> no Compression*/
+    FileManager_Pending*      Pending;      /*NULL -> Blocking reads do not see queued writes*/
+    uint32_t                  WriteTotal;   /*Bytes ever written into WriteStream*/
+    uint16_t                  PendingLen;
+    uint16_t                  PendingHead;
+    uint16_t                  PendingCount;
+    uint32_t                  LastId;       /*Id of last queued command*/
+    uint32_t                  StartedId;    /*Id of last command which is read out of CommandQueue*/
+    uint32_t                  BarrierId;    /*Id of last queued Fill/Const/Copy/Truncate, pending map can not give Bytes which it change*/
+    FileManager_Addr          BarrierLo;    /*range which queued Fill/Const/Copy/Truncate change*/
+    FileManager_Addr          BarrierHi;
+    uint32_t                  Canceled[FILE_MANAGER_CANCEL_DEPTH];
+    uint8_t                   CancelCount;
+    FileManager_Addr          AlignPos;     /*device Address of next append, -1 -> not known*/
+    FileManager_Addr          AlignPhys;    /*device Address of first Byte of File, -1 -> ask driver*/
+    uint32_t                  AlignRun;     /*0 -> appends are not held*/
+    uint32_t                  AlignMaxHold;
+    FileManager_Timestamp     AlignSince;
     void*                     Args;         /*Logger*/
     /*New*/
     void*                     Args1;        /*Logger Argument*/
     //uint32_t                  FileSize;
     /*End*/
+#if FILE_MANAGER_USE_ASYNC
+    FileManager_AsyncOp       AsyncOps[FILE_MANAGER_ASYNC_DEPTH];
+    int32_t                   AsyncBytes;   /*Bytes of Stream in flight*/
+    FileManager_Addr          AsyncEnd;
+    uint8_t                   AsyncHead;
+    uint8_t                   AsyncCount;
+    uint8_t                   AsyncWait;    /*command need sync driver, wait for chunks in flight*/
+    uint8_t                   AsyncRead;    /*onRead is pending*/
+    uint8_t                   AsyncResult;  /*first error of command in flight*/
+#endif
     FileManager_Timestamp     NextTick;
+    FileManager_Timestamp     DirtySince;
+    uint32_t                  DirtyBytes;
+    uint32_t                  SyncThreshold;
+    FileManager_Stats         Stats;
+    uint32_t                  FrameCrc;
+    int32_t                   FrameRemain;
+    FileManager_Addr          FrameAddr;
+    FileManager*              Marker;       ///// checkpoint Records of File go here (File_setCheckpoint)
+    FileManager_Addr          CheckpointEnd;  ///// end of Data of last Record which marker has written
+    FileManager_Addr          CheckpointNext; ///// end of Data of Record in marker queue
+    uint32_t                  CheckpointId;   ///// Id of Record command in marker, 0 -> none
+    uint32_t                  CheckpointSpacing;
+    uint32_t                  CheckpointSeq;
+    uint8_t                   SyncPolicy;
     int16_t                   TempLen;
     uint8_t                   UseForLogger : 1;
     uint8_t                   FirstTimeRun : 1;
@@ -180,7 +426,14 @@ struct _FileManager {
     uint8_t                   InProcess    : 1;
     uint8_t                   Enabled      : 1;
     uint8_t                   FileStatus   : 1;
-    uint8_t                   Reserved     : 2;
+    uint8_t                   Dirty        : 1;
+    uint8_t                   OtherPath    : 1;
+    uint8_t                   Framing      : 1;
+    uint8_t                   FrameOpen    : 1;
+    uint8_t                   Ready        : 1;
+    uint8_t                   Dedupe       : 1;
+    uint8_t                   AlignHeld    : 1;
+    uint8_t                   AlignFlush   : 1;
 };
 
 
@@ -189,13 +442,38 @@ struct _FileManager {
 
 
 FileManager_Result FileManager_add    (FileManager* file, FileManager_Fil* fil, const FileManager_Config* config,  uint8_t* path);
+FileManager_Result FileManager_remove (FileManager* file);
+FileManager*       FileManager_find   (const uint8_t* path);
 void               File_init          (FileManager* file, uint8_t* commandQBuffer, uint16_t commandQLen, uint8_t* qReadBuffer, uint16_t qReadLen, uint8_t* streamWriteBuffer, uint16_t streamWriteLen, uint8_t* streamReadBuffer, uint16_t streamReadLen);
 FileManager_Result FileManager_handle (void);
-FileManager_Result File_writeBlocking (FileManager* file, int32_t addr, uint8_t* data, int32_t len);
-FileManager_Result File_readBlocking  (FileManager* file, int32_t addr, uint8_t* data, int32_t len);
-FileManager_Result File_write         (FileManager* file, int32_t addr, uint8_t* data, int32_t len, FileManager_Type type);
-FileManager_Result File_read          (FileManager* file, int32_t addr, int32_t len);
+FileManager_Result File_writeBlocking (FileManager* file, FileManager_Addr addr, uint8_t* data, int32_t len);
+FileManager_Result File_readBlocking  (FileManager* file, FileManager_Addr addr, uint8_t* data, int32_t len);
+FileManager_Result File_write         (FileManager* file, FileManager_Addr addr, uint8_t* data, int32_t len, FileManager_Type type);
+FileManager_Result File_read          (FileManager* file, FileManager_Addr addr, int32_t len);
+FileManager_Result File_readMapped    (FileManager* file, FileManager_Addr addr, int32_t len);
+FileManager_Result File_readStream    (FileManager* file, FileManager_Addr addr, int32_t len);
 FileManager_Result File_erase         (FileManager* file); 
+FileManager_Result File_truncate      (FileManager* file, FileManager_Addr addr);
+FileManager_Result File_queueTruncate (FileManager* file, FileManager_Addr addr);
+FileManager_Result File_fill          (FileManager* file, FileManager_Addr addr, int32_t len, uint8_t pattern);
+FileManager_Result File_copy          (FileManager* src, FileManager* dst, FileManager_Addr srcAddr, FileManager_Addr dstAddr, int32_t len);
+FileManager_Result File_copyBlocking  (FileManager* src, FileManager* dst, FileManager_Addr srcAddr, FileManager_Addr dstAddr, int32_t len);
+FileManager_Result File_fillBlocking  (FileManager* file, FileManager_Addr addr, int32_t len, uint8_t pattern);
+FileManager_Result File_setCompression (FileManager* file, FileManager_Compress* compress, uint8_t* block, uint16_t blockLen, uint8_t* coded, uint16_t codedLen, FileManager_BlockIndex* index, uint16_t indexLen);
+void               File_setFraming    (FileManager* file, uint8_t enable);
+void               File_setPendingMap (FileManager* file, FileManager_Pending* map, uint16_t len);
+void               File_setDedupe     (FileManager* file, uint8_t enable);
+void               File_setAlignment  (FileManager* file, uint32_t run, FileManager_Addr phys, uint32_t maxHold);
+void               File_setCheckpoint (FileManager* file, FileManager* marker, uint32_t spacing);
+FileManager_Result File_recover       (FileManager* file, FileManager* marker, FileManager_Addr* end);
+FileManager_Addr   File_getCheckpoint (FileManager* file);
+FileManager_Result File_cancel        (FileManager* file, uint32_t id);
+uint32_t           File_getLastId     (FileManager* file);
+void               File_setSyncPolicy (FileManager* file, FileManager_SyncPolicy policy, uint32_t threshold);
+FileManager_Result File_flush         (FileManager* file);
+FileManager_Size   File_getSize       (FileManager* file);
+const FileManager_Stats* File_getStats (FileManager* file);
+void               File_resetStats    (FileManager* file);
 
 void                  FileManager_setArgs                (FileManager* file, void* arg);
 void*                 FileManager_getArgs                (FileManager* file);
@@ -207,10 +485,10 @@ FileManager_Result    FileManager_setNewPath             (FileManager* file, uin
 
 #if FILE_MANAGER_USE_FOR_LOGGER
 Stream*            File_beginWrite    (FileManager* file, Stream* tempStream, int32_t len);
-void               File_endWrite      (FileManager* file, int32_t addr, Stream* tempStream);
-Stream*            File_beginRead     (FileManager* file, int32_t addr, Stream* tempStream, int32_t len);
+FileManager_Result File_endWrite      (FileManager* file, FileManager_Addr addr, Stream* tempStream);
+Stream*            File_beginRead     (FileManager* file, FileManager_Addr addr, Stream* tempStream, int32_t len);
 void               File_endRead       (FileManager* file, Stream* tempStream);         
-FileManager_Result File_loggerRead    (FileManager* file, DateTime_X* dateTime, int32_t addr, int32_t len);
+FileManager_Result File_loggerRead    (FileManager* file, DateTime_X* dateTime, FileManager_Addr addr, int32_t len);
 #endif
 
 
@@ -218,15 +496,22 @@ FileManager_Result File_loggerRead    (FileManager* file, DateTime_X* dateTime,
 typedef FileManager_Result (*FileManager_openFn)              (FileManager* file, uint8_t* path, FileManager_OpenMethod openMethod);
 typedef FileManager_Result (*FileManager_writeFn)             (FileManager* file, void* data, int32_t len);
 typedef FileManager_Result (*FileManager_readFn)              (FileManager* file, void* data, int32_t len);
-typedef FileManager_Result (*FileManager_mountFn)             (FileManager_MountMethod mountStatus);
-typedef FileManager_Result (*FileManager_unMountFn)           (void);
-typedef FileManager_Result (*FileManager_lseekFn)             (FileManager* file, int32_t addr);
+typedef FileManager_Result (*FileManager_mountFn)             (FileManager_Volume* volume, FileManager_MountMethod mountStatus);
+typedef FileManager_Result (*FileManager_unMountFn)           (FileManager_Volume* volume);
+typedef FileManager_Result (*FileManager_lseekFn)             (FileManager* file, FileManager_Addr addr);
 typedef FileManager_Result (*FileManager_closeFn)             (FileManager* file);
 typedef uint8_t            (*FileManager_isOpen)              (FileManager* file);
-typedef uint32_t           (*FileManager_sizeFn)              (FileManager* file);
-typedef uint8_t            (*FileManager_BSP_SD_IsDetectedFn) (void);
+typedef FileManager_Size   (*FileManager_sizeFn)              (FileManager* file);
+typedef uint8_t            (*FileManager_BSP_SD_IsDetectedFn) (FileManager_Volume* volume);
 typedef FileManager_Result (*FileManager_unLinkFileFn)        (uint8_t* path);
 typedef uint32_t           (*FileManager_getTimestampFn)      (void);
+typedef FileManager_Result (*FileManager_truncateFn)          (FileManager* file);
+typedef FileManager_Result (*FileManager_syncFn)              (FileManager* file);
+typedef FileManager_Result (*FileManager_mapFn)               (FileManager* file, FileManager_Addr addr, int32_t len, const uint8_t** view);
+typedef FileManager_Result (*FileManager_unMapFn)             (FileManager* file);
+typedef FileManager_Result (*FileManager_submitFn)            (FileManager* file, FileManager_AsyncOp* op);
+typedef int32_t            (*FileManager_pollFn)              (FileManager_Volume* volume, uint8_t wait);
+typedef FileManager_Addr   (*FileManager_physicalFn)          (FileManager* file);
 
 typedef struct {
     FileManager_openFn              Open;              //// open File in sdCard
@@ -241,25 +526,74 @@ typedef struct {
     FileManager_BSP_SD_IsDetectedFn IsDetected;        //// check your SdCard is detect or Not
     FileManager_unLinkFileFn        UnLink;            //// UnLink(erase) file 
     FileManager_getTimestampFn      GetTimestamp;      //// get timeStamp of your MCU
+    FileManager_truncateFn          Truncate;          //// Truncate File at current Position
+    FileManager_syncFn              Sync;              //// Flush cached Data of open File into SdCard (NULL -> Close is used)
+    FileManager_mapFn               Map;               //// give pointer to File Data in memory (NULL -> not supported)
+    FileManager_unMapFn             UnMap;             //// release memory of Map
+    FileManager_submitFn            Submit;            //// queue one async chunk (NULL -> sync Write/Read)
+    FileManager_pollFn              Poll;              //// reap completed chunks, wait = 1 -> wait for one, return count
+    FileManager_physicalFn          Physical;          //// device Address of first Byte of open File, -1 -> not known (NULL -> not supported)
 } FileManager_Driver;
 
 
-void FileManager_Init (const FileManager_Driver* driver);
+/**
+ * @brief one storage device (SdCard, eMMC, ...), Files of different volumes have their own Driver and mount state
+ */
+struct _FileManager_Volume {
+    struct _FileManager_Volume* Previous;
+    const FileManager_Driver*   Driver;
+    void*                       Context;     ///// port data of device (e.g. FATFS and Path)
+    uint8_t                     Mounted;
+};
 
-FileManager_Result File_writeUInt8Blocking  (FileManager* file, uint8_t val,  int32_t addr);
-uint8_t File_readUInt8Blocking   (FileManager* file, int32_t addr);
-FileManager_Result File_writeUInt16Blocking (FileManager* file, uint16_t val, int32_t addr);
-uint16_t File_readUInt16Blocking (FileManager* file, int32_t addr);
-FileManager_Result File_writeUInt32Blocking (FileManager* file, uint32_t val, int32_t addr);
-uint32_t File_readUInt32Blocking (FileManager* file, int32_t addr);
-FileManager_Result File_writeUInt64Blocking (FileManager* file, uint64_t val, int32_t addr);
-uint64_t File_readUInt64Blocking (FileManager* file, int32_t addr);
+#define  FILE_MANAGER_VOLUME_NULL  ((FileManager_Volume*)0)
+
+
+void FileManager_Init      (const FileManager_Driver* driver);
+void FileManager_addVolume (FileManager_Volume* volume, const FileManager_Driver* driver, void* context);
+void File_setVolume        (FileManager* file, FileManager_Volume* volume);
+void FileManager_setYield  (FileManager_yieldFn fn, void* args);
+
+FileManager_Result File_writeUInt8Blocking  (FileManager* file, uint8_t val,  FileManager_Addr addr);
+uint8_t File_readUInt8Blocking   (FileManager* file, FileManager_Addr addr);
+FileManager_Result File_writeUInt16Blocking (FileManager* file, uint16_t val, FileManager_Addr addr);
+uint16_t File_readUInt16Blocking (FileManager* file, FileManager_Addr addr);
+FileManager_Result File_writeUInt32Blocking (FileManager* file, uint32_t val, FileManager_Addr addr);
+uint32_t File_readUInt32Blocking (FileManager* file, FileManager_Addr addr);
+FileManager_Result File_writeUInt64Blocking (FileManager* file, uint64_t val, FileManager_Addr addr);
+uint64_t File_readUInt64Blocking (FileManager* file, FileManager_Addr addr);
+
+FileManager_Result File_writeArray          (FileManager* file, FileManager_Addr addr, const void* data, int32_t count, uint8_t size, FileManager_Endian endian);
+FileManager_Result File_writeArrayBlocking  (FileManager* file, FileManager_Addr addr, const void* data, int32_t count, uint8_t size, FileManager_Endian endian);
+FileManager_Result File_readArray           (FileManager* file, FileManager_Addr addr, int32_t count, uint8_t size, FileManager_Endian endian);
+FileManager_Result File_readArrayBlocking   (FileManager* file, FileManager_Addr addr, void* data, int32_t count, uint8_t size, FileManager_Endian endian);
+FileManager_Result File_writeArrayU16       (FileManager* file, FileManager_Addr addr, const uint16_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_writeArrayU32       (FileManager* file, FileManager_Addr addr, const uint32_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_writeArrayU64       (FileManager* file, FileManager_Addr addr, const uint64_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_writeArrayF32       (FileManager* file, FileManager_Addr addr, const float* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_writeArrayU16Blocking (FileManager* file, FileManager_Addr addr, const uint16_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_writeArrayU32Blocking (FileManager* file, FileManager_Addr addr, const uint32_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_writeArrayU64Blocking (FileManager* file, FileManager_Addr addr, const uint64_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_writeArrayF32Blocking (FileManager* file, FileManager_Addr addr, const float* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_readArrayU16        (FileManager* file, FileManager_Addr addr, int32_t count, FileManager_Endian endian);
+FileManager_Result File_readArrayU32        (FileManager* file, FileManager_Addr addr, int32_t count, FileManager_Endian endian);
+FileManager_Result File_readArrayU64        (FileManager* file, FileManager_Addr addr, int32_t count, FileManager_Endian endian);
+FileManager_Result File_readArrayF32        (FileManager* file, FileManager_Addr addr, int32_t count, FileManager_Endian endian);
+FileManager_Result File_readArrayU16Blocking (FileManager* file, FileManager_Addr addr, uint16_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_readArrayU32Blocking (FileManager* file, FileManager_Addr addr, uint32_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_readArrayU64Blocking (FileManager* file, FileManager_Addr addr, uint64_t* data, int32_t count, FileManager_Endian endian);
+FileManager_Result File_readArrayF32Blocking (FileManager* file, FileManager_Addr addr, float* data, int32_t count, FileManager_Endian endian);
 
 
 void   File_onRead       (FileManager* file, FileManager_ReadCallbackFn        cb);
 void   File_onNotDetect  (FileManager* file, FileManager_noDetectSDCallbackFn  cb);
 void   File_onCreateFile (FileManager* file, FileManager_createFileCallbackFn  cb);
 void   File_onGetAddress (FileManager* file, FileManager_getAddressFn          cb);
+void   File_onIdle       (FileManager* file, FileManager_idleCallbackFn        cb);
+void   File_onError      (FileManager* file, FileManager_errorCallbackFn       cb);
+void   File_onComplete   (FileManager* file, FileManager_completeCallbackFn    cb);
+void   File_onReadChunk  (FileManager* file, FileManager_readChunkCallbackFn   cb);
+void   File_onCapture    (FileManager* file, FileManager_captureCallbackFn     cb);
 int8_t FileManager_assertMemory (uint8_t* arr1, uint8_t* arr2, uint16_t len);
 
 
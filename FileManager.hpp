@@ -0,0 +1,151 @@
+/**
+ * @file FileManager.hpp
+ * @author Reza Dehghan
+ * @brief Header only C++17 wrapper of FileManager, fm::File own its Queue/Stream Buffers,
+ *        sizes are checked in compile time and File is added/removed in constructor/destructor
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_HPP_
+#define _FILE_MANAGER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "FileManager.h"
+
+namespace fm {
+
+constexpr bool isPowerOf2 (std::size_t x) {
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
+
+/**
+ * @brief one File with statically sized Buffers
+ *
+ * @tparam CmdDepth   max queued commands (power of 2)
+ * @tparam ReadDepth  max queued read commands (power of 2)
+ * @tparam WriteBytes size of WriteStream (multiple of SectorSize)
+ * @tparam ReadBytes  size of ReadStream (multiple of SectorSize)
+ * @tparam SectorSize MaxSS of driver Config
+ */
+template <std::size_t CmdDepth, std::size_t ReadDepth, std::size_t WriteBytes, std::size_t ReadBytes, std::size_t SectorSize = 512>
+class File {
+    static_assert(isPowerOf2(CmdDepth) && isPowerOf2(ReadDepth), "queue depth must be power of 2");
+    static_assert(isPowerOf2(SectorSize), "SectorSize must be power of 2");
+    static_assert(WriteBytes > 0 && WriteBytes % SectorSize == 0, "WriteBytes must be multiple of SectorSize");
+    static_assert(ReadBytes > 0 && ReadBytes % SectorSize == 0, "ReadBytes must be multiple of SectorSize");
+    static_assert(CmdDepth * sizeof(FileManager_CommandHeader) <= UINT16_MAX && ReadDepth * sizeof(FileManager_CommandHeader) <= UINT16_MAX &&
+                  WriteBytes <= UINT16_MAX && ReadBytes <= UINT16_MAX, "File_init take uint16_t lengths");
+
+public:
+    File (FileManager_Fil* fil, const FileManager_Config* config, const char* path) {
+        FileManager_add(&file_, fil, config, reinterpret_cast<uint8_t*>(const_cast<char*>(path)));
+        File_init(&file_, commandQ_, sizeof(commandQ_), readQ_, sizeof(readQ_), writeStream_, sizeof(writeStream_), readStream_, sizeof(readStream_));
+    }
+
+    ~File () {
+        FileManager_remove(&file_);
+    }
+
+    File (const File&)            = delete;                 ///// FileManager keep address of File
+    File& operator= (const File&) = delete;
+
+    FileManager*       get ()                { return &file_; }
+    operator           FileManager* ()       { return &file_; }
+
+    FileManager_Result write (FileManager_Addr addr, const uint8_t* data, int32_t len) {
+        return File_write(&file_, addr, const_cast<uint8_t*>(data), len, FileManager_Var);
+    }
+
+    FileManager_Result read (FileManager_Addr addr, int32_t len) {
+        return File_read(&file_, addr, len);
+    }
+
+    FileManager_Result writeBlocking (FileManager_Addr addr, const uint8_t* data, int32_t len) {
+        return File_writeBlocking(&file_, addr, const_cast<uint8_t*>(data), len);
+    }
+
+    FileManager_Result readBlocking (FileManager_Addr addr, uint8_t* data, int32_t len) {
+        return File_readBlocking(&file_, addr, data, len);
+    }
+
+    /**
+     * @brief NonBlocking write of one value, value is copied into WriteStream
+     */
+    template <typename T>
+    FileManager_Result write (FileManager_Addr addr, const T& val) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        return write(addr, reinterpret_cast<const uint8_t*>(&val), static_cast<int32_t>(sizeof(T)));
+    }
+
+    /**
+     * @brief Blocking write of one value, integers of 1/2/4/8 Bytes use File_writeUIntXBlocking
+     */
+    template <typename T>
+    FileManager_Result writeBlocking (FileManager_Addr addr, T val) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+            return File_writeUInt8Blocking(&file_, static_cast<uint8_t>(val), addr);
+        }
+        else if constexpr (std::is_integral_v<T> && sizeof(T) == 2) {
+            return File_writeUInt16Blocking(&file_, static_cast<uint16_t>(val), addr);
+        }
+        else if constexpr (std::is_integral_v<T> && sizeof(T) == 4) {
+            return File_writeUInt32Blocking(&file_, static_cast<uint32_t>(val), addr);
+        }
+        else if constexpr (std::is_integral_v<T> && sizeof(T) == 8) {
+            return File_writeUInt64Blocking(&file_, static_cast<uint64_t>(val), addr);
+        }
+        else {
+            return writeBlocking(addr, reinterpret_cast<const uint8_t*>(&val), static_cast<int32_t>(sizeof(T)));
+        }
+    }
+
+    /**
+     * @brief Blocking read of one value, integers of 1/2/4/8 Bytes use File_readUIntXBlocking
+     */
+    template <typename T>
+    T readBlocking (FileManager_Addr addr) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>, "T must be trivially copyable");
+        if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+            return static_cast<T>(File_readUInt8Blocking(&file_, addr));
+        }
+        else if constexpr (std::is_integral_v<T> && sizeof(T) == 2) {
+            return static_cast<T>(File_readUInt16Blocking(&file_, addr));
+        }
+        else if constexpr (std::is_integral_v<T> && sizeof(T) == 4) {
+            return static_cast<T>(File_readUInt32Blocking(&file_, addr));
+        }
+        else if constexpr (std::is_integral_v<T> && sizeof(T) == 8) {
+            return static_cast<T>(File_readUInt64Blocking(&file_, addr));
+        }
+        else {
+            T val{};
+            readBlocking(addr, reinterpret_cast<uint8_t*>(&val), static_cast<int32_t>(sizeof(T)));
+            return val;
+        }
+    }
+
+    FileManager_Result flush ()                                                 { return File_flush(&file_); }
+    FileManager_Size   size ()                                                  { return File_getSize(&file_); }
+    void               onRead (FileManager_ReadCallbackFn cb)                   { File_onRead(&file_, cb); }
+    void               onError (FileManager_errorCallbackFn cb)                 { File_onError(&file_, cb); }
+    void               setSyncPolicy (FileManager_SyncPolicy policy, uint32_t threshold) { File_setSyncPolicy(&file_, policy, threshold); }
+
+private:
+    FileManager file_{};
+    uint8_t     commandQ_[CmdDepth * sizeof(FileManager_CommandHeader)];
+    uint8_t     readQ_[ReadDepth * sizeof(FileManager_CommandHeader)];
+    uint8_t     writeStream_[WriteBytes];
+    uint8_t     readStream_[ReadBytes];
+};
+
+} // namespace fm
+
+#endif /* _FILE_MANAGER_HPP_ */
@@ -0,0 +1,100 @@
+#include "FileManagerCRC.h"
+#include <string.h>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#else
+#define FILE_MANAGER_CRC_POLY     0x82F63B78u
+
+static uint32_t crcTable[FILE_MANAGER_CRC_SLICES][256];
+static uint8_t  crcTableReady = 0;
+
+
+
+/**
+ * @brief build slicing Tables (one time)
+ */
+static void FileManagerCRC_initTable (void) {
+    uint32_t crc;
+    uint16_t i;
+    uint8_t  j;
+    for (i = 0; i < 256; i++) {
+        crc = i;
+        for (j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (FILE_MANAGER_CRC_POLY & (0u - (crc & 1)));
+        }
+        crcTable[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++) {
+        for (j = 1; j < FILE_MANAGER_CRC_SLICES; j++) {
+            crcTable[j][i] = (crcTable[j - 1][i] >> 8) ^ crcTable[0][crcTable[j - 1][i] & 0xFF];
+        }
+    }
+    crcTableReady = 1;
+}
+#endif
+
+
+
+/**
+ * @brief update CRC32C with Data, start with FILE_MANAGER_CRC_INIT and end with FileManagerCRC_final
+ * 
+ * @param crc  current CRC
+ * @param data Address of Data
+ * @param len  Length of Data
+ * @return uint32_t 
+ */
+uint32_t FileManagerCRC_update (uint32_t crc, const uint8_t* data, int32_t len) {
+#if defined(__SSE4_2__)
+    uint64_t crc64 = crc;
+    uint64_t val;
+    while (len >= 8) {
+        memcpy(&val, data, sizeof(val));
+        crc64 = _mm_crc32_u64(crc64, val);
+        data += 8;
+        len  -= 8;
+    }
+    crc = (uint32_t)crc64;
+    while (len-- > 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+#else
+    if (!crcTableReady) {
+        FileManagerCRC_initTable();
+    }
+#if FILE_MANAGER_CRC_SLICES == 8
+    uint32_t low;
+    uint32_t high;
+    while (len >= 8) {
+        memcpy(&low,  data,     sizeof(low));
+        memcpy(&high, data + 4, sizeof(high));
+        low ^= crc;                                         ///// little endian MCU and host
+        crc  = crcTable[7][low & 0xFF]          ^ crcTable[6][(low >> 8) & 0xFF] ^
+               crcTable[5][(low >> 16) & 0xFF]  ^ crcTable[4][low >> 24] ^
+               crcTable[3][high & 0xFF]         ^ crcTable[2][(high >> 8) & 0xFF] ^
+               crcTable[1][(high >> 16) & 0xFF] ^ crcTable[0][high >> 24];
+        data += 8;
+        len  -= 8;
+    }
+#endif
+    while (len-- > 0) {
+        crc = (crc >> 8) ^ crcTable[0][(crc ^ *data++) & 0xFF];
+    }
+#endif
+    return crc;
+}
+
+
+
+uint32_t FileManagerCRC_final (uint32_t crc) {
+    return ~crc;
+}
+
+
+
+/**
+ * @brief CRC32C of one Buffer
+ */
+uint32_t FileManagerCRC_calc (const uint8_t* data, int32_t len) {
+    return FileManagerCRC_final(FileManagerCRC_update(FILE_MANAGER_CRC_INIT, data, len));
+}
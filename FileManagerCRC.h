@@ -0,0 +1,34 @@
+/**
+ * @file FileManagerCRC.h
+ * @author Reza Dehghan
+ * @brief CRC32C (Castagnoli), slicing-by-8 Table or SSE4.2 crc32 instruction on host build
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_CRC_H_
+#define _FILE_MANAGER_CRC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define   FILE_MANAGER_CRC_INIT           0xFFFFFFFFu
+#ifndef   FILE_MANAGER_CRC_SLICES
+#define   FILE_MANAGER_CRC_SLICES         8            ///// 8 -> 8KB Table (fast), 1 -> 1KB Table (small MCU)
+#endif
+
+uint32_t FileManagerCRC_update (uint32_t crc, const uint8_t* data, int32_t len);
+uint32_t FileManagerCRC_final  (uint32_t crc);
+uint32_t FileManagerCRC_calc   (const uint8_t* data, int32_t len);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _FILE_MANAGER_CRC_H_ */
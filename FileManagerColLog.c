@@ -0,0 +1,412 @@
+#include "FileManagerColLog.h"
+#include "FileManagerCRC.h"
+
+#define FILE_MANAGER_COLLOG_WIDTH(type)   ((type) == FileManagerColLog_Int16 ? 2 : 4)
+
+
+
+/**
+ * @brief float as int32_t with same order (negative float has its magnitude Bits flipped), function is its own inverse
+ */
+static int32_t FileManagerColLog_floatKey (int32_t bits) {
+    return bits ^ ((bits >> 31) & INT32_MAX);
+}
+
+
+
+/**
+ * @brief min/max of column, simple integer loops so host build auto-vectorise them,
+ *        float is compared as int32_t key (float compare in min/max reduction is not vectorised without -ffast-math), NaN is skipped
+ */
+static void FileManagerColLog_range (uint8_t type, const void* values, uint16_t count, FileManagerColLog_Value* range) {
+    const int16_t* v16 = (const int16_t*)values;
+    const int32_t* v32 = (const int32_t*)values;
+    int32_t        min = INT32_MAX;
+    int32_t        max = INT32_MIN;
+    int32_t        key;
+    int32_t        nan;
+    int32_t        lo;
+    int32_t        hi;
+    int32_t        i;
+
+    switch (type) {
+        case FileManagerColLog_Int16:
+            for (i = 0; i < count; i++) {
+                min = v16[i] < min ? v16[i] : min;
+                max = v16[i] > max ? v16[i] : max;
+            }
+            range[0].I = min;
+            range[1].I = max;
+            break;
+        case FileManagerColLog_Int32:
+            for (i = 0; i < count; i++) {
+                min = v32[i] < min ? v32[i] : min;
+                max = v32[i] > max ? v32[i] : max;
+            }
+            range[0].I = min;
+            range[1].I = max;
+            break;
+        default:
+            for (i = 0; i < count; i++) {
+                key = FileManagerColLog_floatKey(v32[i]);     ///// Bits of float, Block and Scan are uint32_t Buffers
+                nan = -(int32_t)((v32[i] & INT32_MAX) > 0x7F800000);
+                lo  = (key & ~nan) | (INT32_MAX & nan);     ///// masks, not ?:, so GCC see plain min/max reduction
+                hi  = (key & ~nan) | (INT32_MIN & nan);
+                min = lo < min ? lo : min;
+                max = hi > max ? hi : max;
+            }
+            if (count == 0) {
+                min = 0;
+                max = 0;
+            }
+            min = FileManagerColLog_floatKey(min);            ///// all NaN -> min/max are NaN, Block is always skipped
+            max = FileManagerColLog_floatKey(max);
+            memcpy(&range[0].F, &min, sizeof(min));
+            memcpy(&range[1].F, &max, sizeof(max));
+            break;
+    }
+}
+
+
+
+/**
+ * @brief check Block with this min/max can have Records in [lo, hi]
+ */
+static uint8_t FileManagerColLog_overlap (uint8_t type, const FileManagerColLog_Value* range, FileManagerColLog_Value lo, FileManagerColLog_Value hi) {
+    if (type == FileManagerColLog_Float) {
+        return range[0].F <= hi.F && range[1].F >= lo.F;
+    }
+    return range[0].I <= hi.I && range[1].I >= lo.I;
+}
+
+
+
+/**
+ * @brief match[i] = lo <= values[i] <= hi, branch free loops so host build auto-vectorise them
+ *        (restrict: match never alias values, so loops need no aliasing check)
+ * @return uint16_t number of matching Records
+ */
+static uint16_t FileManagerColLog_match (uint8_t type, const void* values, uint16_t count, FileManagerColLog_Value lo, FileManagerColLog_Value hi, uint8_t* restrict match) {
+    const int16_t* restrict v16 = (const int16_t*)values;
+    const int32_t* restrict v32 = (const int32_t*)values;
+    const float*   restrict vf  = (const float*)values;
+    int32_t                 loI = lo.I;
+    int32_t                 hiI = hi.I;
+    float                   loF = lo.F;
+    float                   hiF = hi.F;
+    uint32_t                matched = 0;
+    int32_t                 i;
+
+    switch (type) {
+        case FileManagerColLog_Int16:
+            for (i = 0; i < count; i++) {
+                match[i] = (uint8_t)((v16[i] >= loI) & (v16[i] <= hiI));
+            }
+            break;
+        case FileManagerColLog_Int32:
+            for (i = 0; i < count; i++) {
+                match[i] = (uint8_t)((v32[i] >= loI) & (v32[i] <= hiI));
+            }
+            break;
+        default:
+            for (i = 0; i < count; i++) {
+                match[i] = (uint8_t)((vf[i] >= loF) & (vf[i] <= hiF));
+            }
+            break;
+    }
+    for (i = 0; i < count; i++) {
+        matched += match[i];
+    }
+    return (uint16_t)matched;
+}
+
+
+
+/**
+ * @brief write min/max and Footer into RAM Block and queue Block into File at its Address
+ */
+static FileManager_Result FileManagerColLog_seal (FileManagerColLog* log) {
+    uint8_t*                 block  = (uint8_t*)log->Block;
+    int32_t                  size   = FILE_MANAGER_COLLOG_FOOTER_SIZE(log->Columns);
+    FileManagerColLog_Value* range  = (FileManagerColLog_Value*)(block + log->BlockSize - size);
+    FileManagerColLog_Footer footer;
+    uint8_t                  c;
+
+    if (Stream_space(&log->File->WriteStream) < log->BlockSize || Queue_space(&log->File->CommandQueue) == 0) {
+        return FileManager_DENIED;
+    }
+    for (c = 0; c < log->Columns; c++) {
+        FileManagerColLog_range(log->Types[c], block + log->Offsets[c], log->Count, &range[c * 2]);
+    }
+    footer.Magic    = FILE_MANAGER_COLLOG_MAGIC;
+    footer.Block    = log->Blocks;
+    footer.Count    = log->Count;
+    footer.Columns  = log->Columns;
+    footer.Reserved = 0;
+    footer.Check    = 0;
+    memcpy(block + log->BlockSize - sizeof(footer), &footer, sizeof(footer));
+    footer.Check    = FileManagerCRC_calc((const uint8_t*)range, size);
+    memcpy(block + log->BlockSize - sizeof(footer), &footer, sizeof(footer));
+    return File_write(log->File, (FileManager_Addr)log->Blocks * log->BlockSize, block, log->BlockSize, FileManager_Var);
+}
+
+
+
+/**
+ * @brief read and check Footer of sealed Block into Scan Buffer
+ * @return FileManagerColLog_Value* min/max pairs, NULL if Footer is not valid
+ */
+static FileManagerColLog_Value* FileManagerColLog_readFooter (FileManagerColLog* log, uint32_t block, FileManagerColLog_Footer* footer) {
+    int32_t  size   = FILE_MANAGER_COLLOG_FOOTER_SIZE(log->Columns);
+    uint8_t* buffer = (uint8_t*)log->Scan;
+    uint32_t check;
+
+    if (File_readBlocking(log->File, (FileManager_Addr)(block + 1) * log->BlockSize - size, buffer, size) != FileManager_OK) {
+        return NULL;
+    }
+    memcpy(footer, buffer + size - sizeof(*footer), sizeof(*footer));
+    check         = footer->Check;
+    footer->Check = 0;
+    memcpy(buffer + size - sizeof(*footer), footer, sizeof(*footer));
+    if (footer->Magic != FILE_MANAGER_COLLOG_MAGIC || footer->Block != block || footer->Columns != log->Columns ||
+        footer->Count > log->Capacity || check != FileManagerCRC_calc(buffer, size)) {
+        return NULL;
+    }
+    return (FileManagerColLog_Value*)buffer;
+}
+
+
+
+/**
+ * @brief Initialize Log, Block layout come from column types (Log must be mounted before use)
+ *
+ * @param log       Address of FileManagerColLog
+ * @param file      Address of FileManager (only used by Log)
+ * @param types     FileManagerColLog_Type of each column, Record is packed values of columns in this order
+ * @param columns   Number of columns (<= FILE_MANAGER_COLLOG_MAX_COLUMNS)
+ * @param block     RAM Block (blockSize Bytes), WriteStream of File must hold one Block
+ * @param blockSize Bytes of one Block
+ * @param scan      scan Buffer
+ * @param scanLen   Bytes of scan Buffer
+ * @return FileManager_Result
+ */
+FileManager_Result FileManagerColLog_init (FileManagerColLog* log, FileManager* file, const uint8_t* types, uint8_t columns, uint32_t* block, uint16_t blockSize, uint32_t* scan, uint16_t scanLen) {
+    uint32_t offset = 0;
+    uint8_t  c;
+
+    if (columns < 1 || columns > FILE_MANAGER_COLLOG_MAX_COLUMNS || blockSize % sizeof(uint32_t) != 0 || scanLen < FILE_MANAGER_COLLOG_FOOTER_SIZE(columns)) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    log->File       = file;
+    log->Types      = types;
+    log->Columns    = columns;
+    log->Block      = block;
+    log->BlockSize  = blockSize;
+    log->Scan       = scan;
+    log->ScanLen    = scanLen;
+    log->RecordSize = 0;
+    for (c = 0; c < columns; c++) {
+        log->RecordSize += FILE_MANAGER_COLLOG_WIDTH(types[c]);
+    }
+    if (blockSize <= FILE_MANAGER_COLLOG_FOOTER_SIZE(columns)) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    log->Capacity   = (uint16_t)(((blockSize - FILE_MANAGER_COLLOG_FOOTER_SIZE(columns)) / log->RecordSize) & ~3u);   ///// keep each column word aligned
+    if (log->Capacity == 0) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    for (c = 0; c < columns; c++) {
+        log->Offsets[c] = offset;
+        offset         += (uint32_t)log->Capacity * FILE_MANAGER_COLLOG_WIDTH(types[c]);
+    }
+    log->Count      = 0;
+    log->Full       = 0;
+    log->Blocks     = 0;
+    log->Skipped    = 0;
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief Blocking mount, find last Block of File, a not full last Block is loaded into RAM Block and filled by next appends
+ *
+ * @param log Address of FileManagerColLog
+ * @return FileManager_Result
+ */
+FileManager_Result FileManagerColLog_mount (FileManagerColLog* log) {
+    FileManagerColLog_Footer footer;
+    FileManager_Size         size = File_getSize(log->File);
+
+    log->Blocks = (uint32_t)(size / log->BlockSize);
+    log->Count  = 0;
+    log->Full   = 0;
+    memset(log->Block, 0, log->BlockSize);
+    if (log->Blocks == 0) {
+        return FileManager_OK;
+    }
+    if (FileManagerColLog_readFooter(log, log->Blocks - 1, &footer) == NULL) {
+        return FileManager_OK;                              ///// last Block is broken, next Block is written after it
+    }
+    if (footer.Count < log->Capacity) {
+        log->Blocks--;
+        log->Count = footer.Count;
+        return File_readBlocking(log->File, (FileManager_Addr)log->Blocks * log->BlockSize, (uint8_t*)log->Block, log->BlockSize);
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief NonBlocking append of one Record, full Block is queued into File
+ *
+ * @param log    Address of FileManagerColLog
+ * @param record packed values of all columns
+ * @return FileManager_Result FileManager_DENIED if queue of File has no space for full Block (Record is not added)
+ */
+FileManager_Result FileManagerColLog_append (FileManagerColLog* log, const void* record) {
+    const uint8_t* value = (const uint8_t*)record;
+    uint8_t*       block = (uint8_t*)log->Block;
+    uint8_t        width;
+    uint8_t        c;
+
+    if (log->Full) {
+        if (FileManagerColLog_seal(log) != FileManager_OK) {
+            return FileManager_DENIED;
+        }
+        log->Blocks++;
+        log->Count = 0;
+        log->Full  = 0;
+    }
+    for (c = 0; c < log->Columns; c++) {
+        width = FILE_MANAGER_COLLOG_WIDTH(log->Types[c]);
+        memcpy(block + log->Offsets[c] + (uint32_t)log->Count * width, value, width);
+        value += width;
+    }
+    log->Count++;
+    if (log->Count == log->Capacity) {
+        log->Full = 1;
+        if (FileManagerColLog_seal(log) == FileManager_OK) {
+            log->Blocks++;
+            log->Count = 0;
+            log->Full  = 0;
+        }
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief NonBlocking write of not full RAM Block, Block stay in RAM and is written again when it is full
+ *
+ * @param log Address of FileManagerColLog
+ * @return FileManager_Result
+ */
+FileManager_Result FileManagerColLog_flush (FileManagerColLog* log) {
+    if (log->Count == 0) {
+        return FileManager_OK;
+    }
+    if (log->Full) {
+        if (FileManagerColLog_seal(log) != FileManager_OK) {
+            return FileManager_DENIED;
+        }
+        log->Blocks++;
+        log->Count = 0;
+        log->Full  = 0;
+        return FileManager_OK;
+    }
+    return FileManagerColLog_seal(log);
+}
+
+
+
+/**
+ * @brief Blocking scan of one column, Blocks whose min/max can not be in [lo, hi] are skipped by reading only Footer,
+ *        other Blocks read only scanned column, RAM Block is scanned too (Blocks still in queue of File are not seen)
+ *
+ * @param log    Address of FileManagerColLog
+ * @param column scanned column
+ * @param lo     min value (I for Int16/Int32 columns, F for Float columns)
+ * @param hi     max value
+ * @param fn     called for each Block which has matching Records
+ * @param args   passed to fn
+ * @return FileManager_Result FileManager_NOT_ENOUGH_CORE if scan Buffer is smaller than Capacity * (width + 1)
+ */
+FileManager_Result FileManagerColLog_scan (FileManagerColLog* log, uint8_t column, FileManagerColLog_Value lo, FileManagerColLog_Value hi, FileManagerColLog_scanFn fn, void* args) {
+    FileManagerColLog_Footer footer;
+    FileManagerColLog_Value* range;
+    FileManagerColLog_Value  ramRange[2];
+    uint8_t                  type;
+    uint8_t                  width;
+    uint8_t*                 match;
+    const void*              values;
+    uint16_t                 count;
+    uint32_t                 block;
+
+    if (column >= log->Columns) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    type  = log->Types[column];
+    width = FILE_MANAGER_COLLOG_WIDTH(type);
+    if ((uint32_t)log->Capacity * (width + 1) > log->ScanLen) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    match        = (uint8_t*)log->Scan + (uint32_t)log->Capacity * width;
+    log->Skipped = 0;
+    for (block = 0; block <= log->Blocks; block++) {
+        if (block == log->Blocks) {
+            count  = log->Count;
+            values = (const uint8_t*)log->Block + log->Offsets[column];
+            FileManagerColLog_range(type, values, count, ramRange);
+            range  = ramRange;                              ///// min/max of scanned column only
+        }
+        else {
+            range = FileManagerColLog_readFooter(log, block, &footer);
+            if (range == NULL) {
+                continue;                                   ///// broken Block
+            }
+            range += column * 2;
+            count  = footer.Count;
+            values = log->Scan;
+        }
+        if (count == 0 || !FileManagerColLog_overlap(type, range, lo, hi)) {
+            log->Skipped++;
+            continue;
+        }
+        if (block != log->Blocks &&
+            File_readBlocking(log->File, (FileManager_Addr)block * log->BlockSize + log->Offsets[column], (uint8_t*)log->Scan, (int32_t)count * width) != FileManager_OK) {
+            return FileManager_DISK_ERR;
+        }
+        if (FileManagerColLog_match(type, values, count, lo, hi, match) > 0 && fn != NULL) {
+            fn(log, block, values, match, count, args);
+        }
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief Blocking read of one column of Block (e.g. other columns of matching Records in scan callback)
+ *
+ * @param log    Address of FileManagerColLog
+ * @param block  index of Block
+ * @param column column
+ * @param out    Address of count values (type of column)
+ * @param count  Records of Block (count of scan callback)
+ * @return FileManager_Result
+ */
+FileManager_Result FileManagerColLog_readColumn (FileManagerColLog* log, uint32_t block, uint8_t column, void* out, uint16_t count) {
+    uint8_t width;
+    if (column >= log->Columns || block > log->Blocks || count > log->Capacity) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    width = FILE_MANAGER_COLLOG_WIDTH(log->Types[column]);
+    if (block == log->Blocks) {
+        memcpy(out, (const uint8_t*)log->Block + log->Offsets[column], (uint32_t)count * width);
+        return FileManager_OK;
+    }
+    return File_readBlocking(log->File, (FileManager_Addr)block * log->BlockSize + log->Offsets[column], (uint8_t*)out, (int32_t)count * width);
+}
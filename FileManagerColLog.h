@@ -0,0 +1,94 @@
+/**
+ * @file FileManagerColLog.h
+ * @author Reza Dehghan
+ * @brief Columnar Block Log on top of one FileManager File
+ *        Records are kept column by column in fixed size Blocks, Footer of each Block keep min/max of each column
+ *        and Record count, scan read only Footers and skip Blocks which can not match
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_COLLOG_H_
+#define _FILE_MANAGER_COLLOG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FileManager.h"
+
+#define   FILE_MANAGER_COLLOG_MAGIC         0x474C4F43   ///// "COLG"
+#define   FILE_MANAGER_COLLOG_MAX_COLUMNS   16
+#define   FILE_MANAGER_COLLOG_FOOTER_SIZE(columns)   ((int32_t)sizeof(FileManagerColLog_Footer) + (columns) * 2 * (int32_t)sizeof(FileManagerColLog_Value))
+
+typedef enum {
+    FileManagerColLog_Int16      = 0x00,
+    FileManagerColLog_Int32      = 0x01,
+    FileManagerColLog_Float      = 0x02,
+} FileManagerColLog_Type;
+
+
+/**
+ * @brief min/max of column, I for Int16/Int32 columns, F for Float columns
+ */
+typedef union {
+    int32_t                I;
+    float                  F;
+} FileManagerColLog_Value;
+
+
+/**
+ * @brief last Bytes of each Block, min/max pairs of all columns come before it
+ */
+typedef struct {
+    uint32_t               Magic;
+    uint32_t               Block;        ///// index of Block in File
+    uint16_t               Count;        ///// Records in Block
+    uint8_t                Columns;
+    uint8_t                Reserved;
+    uint32_t               Check;        ///// CRC32C of min/max pairs and Footer (Check = 0)
+} FileManagerColLog_Footer;
+
+
+typedef struct _FileManagerColLog FileManagerColLog;
+
+/**
+ * @brief called for each Block which has matching Records, match[i] is 1 when Record i match,
+ *        values are Records of scanned column (type of column)
+ */
+typedef void (*FileManagerColLog_scanFn) (FileManagerColLog* log, uint32_t block, const void* values, const uint8_t* match, uint16_t count, void* args);
+
+
+struct _FileManagerColLog {
+    FileManager*           File;
+    const uint8_t*         Types;        ///// FileManagerColLog_Type of each column
+    uint32_t*              Block;        ///// RAM Block which is filled by append
+    uint32_t*              Scan;         ///// scan Buffer
+    uint16_t               BlockSize;    ///// Bytes of Block in File, keep it multiple of MaxSS
+    uint16_t               ScanLen;      ///// Bytes of scan Buffer, BlockSize + BlockSize / 4 is always enough
+    uint16_t               Capacity;     ///// Records in one Block
+    uint16_t               Count;        ///// Records in RAM Block
+    uint16_t               RecordSize;   ///// Bytes of one packed Record
+    uint8_t                Columns;
+    uint8_t                Full;         ///// RAM Block is full and wait for space in queue of File
+    uint32_t               Blocks;       ///// index of RAM Block, Blocks before it are sealed
+    uint32_t               Skipped;      ///// Blocks skipped by Footer in last scan
+    uint32_t               Offsets[FILE_MANAGER_COLLOG_MAX_COLUMNS];   ///// Offset of each column in Block
+};
+
+
+FileManager_Result FileManagerColLog_init       (FileManagerColLog* log, FileManager* file, const uint8_t* types, uint8_t columns, uint32_t* block, uint16_t blockSize, uint32_t* scan, uint16_t scanLen);
+FileManager_Result FileManagerColLog_mount      (FileManagerColLog* log);
+FileManager_Result FileManagerColLog_append     (FileManagerColLog* log, const void* record);
+FileManager_Result FileManagerColLog_flush      (FileManagerColLog* log);
+FileManager_Result FileManagerColLog_scan       (FileManagerColLog* log, uint8_t column, FileManagerColLog_Value lo, FileManagerColLog_Value hi, FileManagerColLog_scanFn fn, void* args);
+FileManager_Result FileManagerColLog_readColumn (FileManagerColLog* log, uint32_t block, uint8_t column, void* out, uint16_t count);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _FILE_MANAGER_COLLOG_H_ */
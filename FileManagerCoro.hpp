@@ -0,0 +1,240 @@
+/**
+ * @file FileManagerCoro.hpp
+ * @author Reza Dehghan
+ * @brief C++20 coroutine interface over NonBlocking FileManager, co_await write/read of fm::AsyncFile
+ *        resume in FileManager_handle when command is finished, coroutine frames come from fixed pool
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_CORO_HPP_
+#define _FILE_MANAGER_CORO_HPP_
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <span>
+#include "FileManager.h"
+
+#ifndef   FILE_MANAGER_CORO_FRAME_SIZE
+#define   FILE_MANAGER_CORO_FRAME_SIZE    512          ///// max Bytes of one coroutine frame (locals kept over co_await live here)
+#endif
+#ifndef   FILE_MANAGER_CORO_FRAMES
+#define   FILE_MANAGER_CORO_FRAMES        16           ///// max coroutines alive together
+#endif
+
+namespace fm {
+
+/**
+ * @brief fixed pool of coroutine frames, allocate/release are O(1) and use no heap
+ */
+class FramePool {
+public:
+    static void* allocate (std::size_t size) noexcept {
+        Frame* frame;
+        if (size > FILE_MANAGER_CORO_FRAME_SIZE) {
+            return nullptr;
+        }
+        if (free_ != nullptr) {
+            frame = free_;
+            free_ = frame->Next;
+        }
+        else if (unused_ < FILE_MANAGER_CORO_FRAMES) {
+            frame = &frames_[unused_++];
+        }
+        else {
+            return nullptr;
+        }
+        return frame->Data;
+    }
+
+    static void release (void* data) noexcept {
+        Frame* frame = reinterpret_cast<Frame*>(data);
+        frame->Next  = free_;
+        free_        = frame;
+    }
+
+private:
+    union alignas(std::max_align_t) Frame {
+        Frame*        Next;
+        unsigned char Data[FILE_MANAGER_CORO_FRAME_SIZE];
+    };
+
+    inline static Frame       frames_[FILE_MANAGER_CORO_FRAMES];
+    inline static Frame*      free_   = nullptr;
+    inline static std::size_t unused_ = 0;
+};
+
+
+/**
+ * @brief detached coroutine, frame is released when coroutine return
+ *        started() is false when FramePool has no free frame (coroutine did not run)
+ */
+class Task {
+public:
+    struct promise_type {
+        Task                get_return_object () noexcept                       { return Task(true); }
+        static Task         get_return_object_on_allocation_failure () noexcept { return Task(false); }
+        std::suspend_never  initial_suspend () noexcept                         { return {}; }
+        std::suspend_never  final_suspend () noexcept                           { return {}; }
+        void                return_void () noexcept                             {}
+        void                unhandled_exception () noexcept                     { std::terminate(); }
+        static void*        operator new (std::size_t size) noexcept            { return FramePool::allocate(size); }
+        static void         operator delete (void* frame) noexcept              { FramePool::release(frame); }
+    };
+
+    bool started () const { return started_; }
+
+private:
+    explicit Task (bool started) : started_(started) {}
+    bool started_;
+};
+
+
+struct ReadResult {
+    FileManager_Result Result;
+    int32_t            Len;                             ///// Bytes copied into out
+};
+
+
+/**
+ * @brief awaitable front end of one File, it use onRead/onComplete and Args of File
+ *        all commands of File must go through it, awaiter is found by Id of its command, so canceled (FileManager_DENIED)
+ *        and deduped commands resume their own coroutine
+ */
+class AsyncFile {
+    struct Op {
+        Op*                     Next   = nullptr;
+        std::coroutine_handle<> Handle;
+        std::span<uint8_t>      Out;
+        uint32_t                Id     = 0;             ///// Id of command (File_getLastId after queue it)
+        int32_t                 Len    = 0;
+        FileManager_Result      Result = FileManager_OK;
+    };
+
+public:
+    class WriteAwaiter {
+    public:
+        WriteAwaiter (AsyncFile* owner, FileManager_Addr addr, std::span<const uint8_t> data) : owner_(owner), addr_(addr), data_(data) {}
+        bool await_ready () const noexcept { return false; }
+        bool await_suspend (std::coroutine_handle<> handle) noexcept {
+            uint32_t lastId = File_getLastId(owner_->file_);
+            op_.Handle = handle;
+            op_.Result = File_write(owner_->file_, addr_, const_cast<uint8_t*>(data_.data()), static_cast<int32_t>(data_.size()), FileManager_Var);
+            if (op_.Result != FileManager_OK || File_getLastId(owner_->file_) == lastId) {
+                return false;                               ///// error or no command is queued
+            }
+            op_.Id = File_getLastId(owner_->file_);
+            owner_->push(&op_);
+            return true;
+        }
+        FileManager_Result await_resume () const noexcept { return op_.Result; }
+
+    private:
+        AsyncFile*               owner_;
+        FileManager_Addr         addr_;
+        std::span<const uint8_t> data_;
+        Op                       op_;
+    };
+
+    class ReadAwaiter {
+    public:
+        ReadAwaiter (AsyncFile* owner, FileManager_Addr addr, std::span<uint8_t> out) : owner_(owner), addr_(addr) { op_.Out = out; }
+        bool await_ready () const noexcept { return false; }
+        bool await_suspend (std::coroutine_handle<> handle) noexcept {
+            op_.Handle = handle;
+            op_.Result = File_read(owner_->file_, addr_, static_cast<int32_t>(op_.Out.size()));
+            if (op_.Result != FileManager_OK) {
+                return false;
+            }
+            op_.Id = File_getLastId(owner_->file_);
+            owner_->push(&op_);
+            return true;
+        }
+        ReadResult await_resume () const noexcept { return { op_.Result, op_.Len }; }
+
+    private:
+        AsyncFile*       owner_;
+        FileManager_Addr addr_;
+        Op               op_;
+    };
+
+    explicit AsyncFile (FileManager* file) : file_(file) {
+        FileManager_setArgs(file, this);
+        File_onRead(file, onRead);
+        File_onComplete(file, onComplete);
+    }
+
+    AsyncFile (const AsyncFile&)            = delete;
+    AsyncFile& operator= (const AsyncFile&) = delete;
+
+    /**
+     * @brief co_await write -> FileManager_Result when Data is written (and committed by SyncPolicy),
+     *        FileManager_DENIED when command is canceled (newer write of same region replaced it by Dedupe)
+     */
+    WriteAwaiter write (FileManager_Addr addr, std::span<const uint8_t> data) { return WriteAwaiter(this, addr, data); }
+
+    /**
+     * @brief co_await read -> ReadResult, out.size() Bytes are read into out
+     */
+    ReadAwaiter  read (FileManager_Addr addr, std::span<uint8_t> out)         { return ReadAwaiter(this, addr, out); }
+
+    FileManager* get ()                                               { return file_; }
+
+private:
+    void push (Op* op) {
+        op->Next = head_;
+        head_    = op;
+    }
+
+    Op* find (uint32_t id) {
+        Op* op = head_;
+        while (op != nullptr && op->Id != id) {
+            op = op->Next;
+        }
+        return op;
+    }
+
+    void unlink (Op* op) {
+        Op** link = &head_;
+        while (*link != op) {
+            link = &(*link)->Next;
+        }
+        *link = op->Next;
+    }
+
+    static void onRead (FileManager* file, Stream* stream, FileManager_CommandHeader* command) {
+        AsyncFile* self = static_cast<AsyncFile*>(FileManager_getArgs(file));
+        Op*        op   = self->find(command->Id);
+        int32_t    len  = Stream_available(stream);
+        if (op == nullptr) {
+            return;
+        }
+        if (len > static_cast<int32_t>(op->Out.size()) - op->Len) {
+            len = static_cast<int32_t>(op->Out.size()) - op->Len;
+        }
+        Stream_readBytes(stream, op->Out.data() + op->Len, len);
+        op->Len += len;
+    }
+
+    static void onComplete (FileManager* file, FileManager_CommandHeader* command, FileManager_Result result) {
+        AsyncFile* self = static_cast<AsyncFile*>(FileManager_getArgs(file));
+        Op*        op   = self->find(command->Id);
+        if (op != nullptr) {
+            self->unlink(op);
+            op->Result = result;
+            op->Handle.resume();                            ///// coroutine run inside FileManager_handle
+        }
+    }
+
+    FileManager* file_;
+    Op*          head_ = nullptr;                           ///// awaiters in flight, few of them so list is walked
+};
+
+} // namespace fm
+
+#endif /* _FILE_MANAGER_CORO_HPP_ */
@@ -0,0 +1,488 @@
+#include "FileManagerKV.h"
+
+#define FILE_MANAGER_KV_RECORD_SIZE(len)   ((int32_t)sizeof(FileManagerKV_Record) + (len))
+
+
+static void FileManagerKV_onIdle (FileManager* file);
+
+
+
+/**
+ * @brief Fletcher16 checksum
+ */
+static uint16_t FileManagerKV_fletcher (uint16_t sum, const uint8_t* data, uint16_t len) {
+    uint16_t sum1 = sum & 0xFF;
+    uint16_t sum2 = sum >> 8;
+    while (len-- > 0) {
+        sum1 = (sum1 + *data++) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+static uint16_t FileManagerKV_check (FileManagerKV_Record* record, const uint8_t* value) {
+    FileManagerKV_Record temp = *record;
+    temp.Check = 0;
+    return FileManagerKV_fletcher(FileManagerKV_fletcher(0, (const uint8_t*)&temp, sizeof(temp)), value, record->Len);
+}
+
+
+
+/**
+ * @brief find slot of key in Index, return first empty slot if key not exist, NULL if Index is full
+ */
+static FileManagerKV_Entry* FileManagerKV_find (FileManagerKV* kv, uint16_t key) {
+    uint16_t mask = kv->IndexLen - 1;
+    uint16_t slot = (uint16_t)(key * 40503u) & mask;
+    uint16_t count;
+    for (count = 0; count < kv->IndexLen; count++) {
+        if (kv->Index[slot].Key == key || kv->Index[slot].Key == FILE_MANAGER_KV_HEADER_KEY) {
+            return &kv->Index[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+
+
+/**
+ * @brief build Record in kv->Buffer
+ * @return int32_t size of Record
+ */
+static int32_t FileManagerKV_build (FileManagerKV* kv, uint8_t flags, uint16_t key, const void* value, uint16_t len) {
+    FileManagerKV_Record record;
+    record.Magic = FILE_MANAGER_KV_MAGIC;
+    record.Flags = flags;
+    record.Key   = key;
+    record.Len   = len;
+    record.Check = FileManagerKV_check(&record, (const uint8_t*)value);
+    if (len > 0) {
+        memmove(kv->Buffer + sizeof(record), value, len);
+    }
+    memcpy(kv->Buffer, &record, sizeof(record));
+    return FILE_MANAGER_KV_RECORD_SIZE(len);
+}
+
+
+
+/**
+ * @brief check File can queue one Record
+ */
+static uint8_t FileManagerKV_hasSpace (FileManager* file, int32_t size) {
+    return Stream_space(&file->WriteStream) >= size && Queue_space(&file->CommandQueue) > 0;
+}
+
+
+
+/**
+ * @brief queue Record of kv->Buffer into File at addr
+ */
+static FileManager_Result FileManagerKV_append (FileManager* file, int32_t addr, FileManagerKV* kv, int32_t size) {
+    if (!FileManagerKV_hasSpace(file, size)) {
+        return FileManager_DENIED;
+    }
+    return File_write(file, addr, kv->Buffer, size, FileManager_Var);
+}
+
+
+
+/**
+ * @brief apply one valid Record of active File into Index
+ */
+static FileManager_Result FileManagerKV_apply (FileManagerKV* kv, FileManagerKV_Record* record, int32_t offset) {
+    FileManagerKV_Entry* entry = FileManagerKV_find(kv, record->Key);
+    if (entry == NULL) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    if (entry->Key == record->Key && entry->Offset >= 0) {
+        kv->LiveBytes -= FILE_MANAGER_KV_RECORD_SIZE(entry->Len);
+    }
+    entry->Key          = record->Key;
+    entry->ShadowOffset = -1;
+    if (record->Flags == FileManagerKV_Deleted) {
+        entry->Offset = -1;
+        entry->Len    = 0;
+    }
+    else {
+        entry->Offset  = offset;
+        entry->Len     = record->Len;
+        kv->LiveBytes += FILE_MANAGER_KV_RECORD_SIZE(record->Len);
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief read Generation of File, return 0 if File has no valid Header
+ */
+static uint32_t FileManagerKV_readGeneration (FileManagerKV* kv, FileManager* file) {
+    FileManagerKV_Record record;
+    uint32_t             generation = 0;
+    if (File_getSize(file) < FILE_MANAGER_KV_HEADER_SIZE ||
+        File_readBlocking(file, 0, kv->Buffer, FILE_MANAGER_KV_HEADER_SIZE) != FileManager_OK) {
+        return 0;
+    }
+    memcpy(&record, kv->Buffer, sizeof(record));
+    if (record.Magic != FILE_MANAGER_KV_MAGIC || record.Key != FILE_MANAGER_KV_HEADER_KEY || record.Len != sizeof(generation) ||
+        record.Check != FileManagerKV_check(&record, kv->Buffer + sizeof(record))) {
+        return 0;
+    }
+    memcpy(&generation, kv->Buffer + sizeof(record), sizeof(generation));
+    return generation;
+}
+
+
+
+/**
+ * @brief one sequential scan of active File, rebuild Index and find End of valid Records
+ */
+static FileManager_Result FileManagerKV_scan (FileManagerKV* kv) {
+    FileManager*         file  = kv->Files[kv->Active];
+    int32_t              size  = (int32_t)File_getSize(file);
+    int32_t              off   = FILE_MANAGER_KV_HEADER_SIZE;
+    int32_t              chunk;
+    int32_t              pos   = 0;
+    uint8_t              valid = 1;
+    FileManager_Result   result;
+    FileManagerKV_Record record;
+
+    while (valid && off + (int32_t)sizeof(record) <= size) {
+        chunk  = size - off > kv->BufferLen ? kv->BufferLen : size - off;
+        result = File_readBlocking(file, off, kv->Buffer, chunk);
+        if (result != FileManager_OK) {
+            return result;
+        }
+        pos = 0;
+        while (pos + (int32_t)sizeof(record) <= chunk) {
+            memcpy(&record, kv->Buffer + pos, sizeof(record));
+            if (record.Magic != FILE_MANAGER_KV_MAGIC || record.Key == FILE_MANAGER_KV_HEADER_KEY ||
+                FILE_MANAGER_KV_RECORD_SIZE(record.Len) > kv->BufferLen || off + pos + FILE_MANAGER_KV_RECORD_SIZE(record.Len) > size) {
+                valid = 0;
+                break;
+            }
+            if (pos + FILE_MANAGER_KV_RECORD_SIZE(record.Len) > chunk) {
+                break;                                      ///// Record cut at end of Buffer, read again from Record start
+            }
+            if (record.Check != FileManagerKV_check(&record, kv->Buffer + pos + sizeof(record))) {
+                valid = 0;
+                break;
+            }
+            result = FileManagerKV_apply(kv, &record, off + pos);
+            if (result != FileManager_OK) {
+                return result;
+            }
+            pos += FILE_MANAGER_KV_RECORD_SIZE(record.Len);
+        }
+        off += pos;
+        if (pos == 0) {
+            break;
+        }
+    }
+    kv->End     = off;
+    kv->Written = off;
+    if (off < size) {
+        return File_truncate(file, off);                    ///// cut torn tail
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief Initial Key-Value Store
+ *
+ * @param kv               Address of FileManagerKV
+ * @param file0            first File (FileManager_add and File_init must be called before)
+ * @param file1            second File, used for Compaction
+ * @param index            Address of Index Buffer
+ * @param indexLen         Number of Index Entries (power of 2, more than number of Keys)
+ * @param buffer           Address of Record Buffer
+ * @param bufferLen        sizeof Record Buffer
+ * @param compactThreshold garbage Bytes in File before Compaction start
+ */
+void FileManagerKV_init (FileManagerKV* kv, FileManager* file0, FileManager* file1, FileManagerKV_Entry* index, uint16_t indexLen, uint8_t* buffer, uint16_t bufferLen, uint32_t compactThreshold) {
+    kv->Files[0]         = file0;
+    kv->Files[1]         = file1;
+    kv->Index            = index;
+    kv->IndexLen         = indexLen;
+    kv->Buffer           = buffer;
+    kv->BufferLen        = bufferLen;
+    kv->CompactThreshold = compactThreshold;
+    kv->Generation       = 0;
+    kv->End              = 0;
+    kv->Written          = 0;
+    kv->LiveBytes        = 0;
+    kv->Active           = 0;
+    kv->Compacting       = 0;
+    kv->Finishing        = 0;
+    FileManager_setArgs(file0, kv);
+    FileManager_setArgs(file1, kv);
+    File_onIdle(file0, FileManagerKV_onIdle);
+    File_onIdle(file1, FileManagerKV_onIdle);
+}
+
+
+
+/**
+ * @brief Blocking Mount of Key-Value Store, select newer File and rebuild Index by one sequential scan
+ *
+ * @param kv Address of FileManagerKV
+ * @return FileManager_Result
+ */
+FileManager_Result FileManagerKV_mount (FileManagerKV* kv) {
+    uint32_t           generation0;
+    uint32_t           generation1;
+    uint16_t           i;
+    FileManager_Result result;
+
+    for (i = 0; i < kv->IndexLen; i++) {
+        kv->Index[i].Key          = FILE_MANAGER_KV_HEADER_KEY;
+        kv->Index[i].Offset       = -1;
+        kv->Index[i].ShadowOffset = -1;
+    }
+    kv->LiveBytes  = 0;
+    kv->Compacting = 0;
+    kv->Finishing  = 0;
+    generation0    = FileManagerKV_readGeneration(kv, kv->Files[0]);
+    generation1    = FileManagerKV_readGeneration(kv, kv->Files[1]);
+    if (generation0 == 0 && generation1 == 0) {
+        kv->Active     = 0;
+        kv->Generation = 1;
+        result = File_erase(kv->Files[0]);
+        if (result == FileManager_OK) {
+            result = File_writeBlocking(kv->Files[0], 0, kv->Buffer, FileManagerKV_build(kv, FileManagerKV_Value, FILE_MANAGER_KV_HEADER_KEY, &kv->Generation, sizeof(kv->Generation)));
+        }
+        kv->End     = FILE_MANAGER_KV_HEADER_SIZE;
+        kv->Written = kv->End;
+        return result;
+    }
+    kv->Active     = generation1 > generation0 ? 1 : 0;
+    kv->Generation = generation1 > generation0 ? generation1 : generation0;
+    return FileManagerKV_scan(kv);
+}
+
+
+
+/**
+ * @brief NonBlocking put, append one Record at end of active File
+ *
+ * @param kv    Address of FileManagerKV
+ * @param key   Key (FILE_MANAGER_KV_HEADER_KEY is reserved)
+ * @param value Address of Value
+ * @param len   Length of Value (Record must fit in Buffer)
+ * @return FileManager_Result FileManager_DENIED if queue of File is full
+ */
+FileManager_Result FileManagerKV_put (FileManagerKV* kv, uint16_t key, const void* value, uint16_t len) {
+    FileManagerKV_Entry* entry = FileManagerKV_find(kv, key);
+    int32_t              size;
+    FileManager_Result   result;
+
+    if (key == FILE_MANAGER_KV_HEADER_KEY || FILE_MANAGER_KV_RECORD_SIZE(len) > kv->BufferLen) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    if (entry == NULL) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    if (kv->Compacting && !FileManagerKV_hasSpace(kv->Files[kv->Active ^ 1], FILE_MANAGER_KV_RECORD_SIZE(len))) {
+        return FileManager_DENIED;                          ///// Record must go into both Files while Compaction
+    }
+    size   = FileManagerKV_build(kv, FileManagerKV_Value, key, value, len);
+    result = FileManagerKV_append(kv->Files[kv->Active], kv->End, kv, size);
+    if (result != FileManager_OK) {
+        return result;
+    }
+    if (entry->Key == key && entry->Offset >= 0) {
+        kv->LiveBytes -= FILE_MANAGER_KV_RECORD_SIZE(entry->Len);
+    }
+    entry->Key          = key;
+    entry->Len          = len;
+    entry->Offset       = kv->End;
+    entry->ShadowOffset = -1;
+    kv->End            += size;
+    kv->LiveBytes      += size;
+    if (kv->Compacting) {
+        FileManagerKV_append(kv->Files[kv->Active ^ 1], kv->ShadowEnd, kv, size);
+        entry->ShadowOffset = kv->ShadowEnd;                ///// Compaction do not copy it again
+        kv->ShadowEnd      += size;
+    }
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief Blocking get Value of Key, Index lookup is in RAM and Value need one read
+ *
+ * @param kv    Address of FileManagerKV
+ * @param key   Key
+ * @param value Address of Buffer for Value
+ * @param len   sizeof Buffer, Value is cut if it is bigger
+ * @return FileManager_Result FileManager_NO_FILE if Key not exist,
+ *         FileManager_LOCKED if Record is in queue yet and File has no pending map (File_setPendingMap)
+ */
+FileManager_Result FileManagerKV_get (FileManagerKV* kv, uint16_t key, void* value, uint16_t len) {
+    FileManagerKV_Entry* entry = FileManagerKV_find(kv, key);
+    if (entry == NULL || entry->Key != key || entry->Offset < 0) {
+        return FileManager_NO_FILE;
+    }
+    if (entry->Offset + FILE_MANAGER_KV_RECORD_SIZE(entry->Len) > kv->Written && kv->Files[kv->Active]->Pending == NULL) {
+        return FileManager_LOCKED;                          ///// with pending map File_readBlocking take Value out of WriteStream
+    }
+    if (entry->Len == 0) {
+        return FileManager_OK;
+    }
+    return File_readBlocking(kv->Files[kv->Active], entry->Offset + sizeof(FileManagerKV_Record), (uint8_t*)value, len < entry->Len ? len : entry->Len);
+}
+
+
+
+/**
+ * @brief return Length of Value of Key, -1 if Key not exist
+ */
+int32_t FileManagerKV_getLen (FileManagerKV* kv, uint16_t key) {
+    FileManagerKV_Entry* entry = FileManagerKV_find(kv, key);
+    if (entry == NULL || entry->Key != key || entry->Offset < 0) {
+        return -1;
+    }
+    return entry->Len;
+}
+
+
+
+/**
+ * @brief NonBlocking remove Key, append one deleted Record
+ *
+ * @param kv  Address of FileManagerKV
+ * @param key Key
+ * @return FileManager_Result
+ */
+FileManager_Result FileManagerKV_remove (FileManagerKV* kv, uint16_t key) {
+    FileManagerKV_Entry* entry = FileManagerKV_find(kv, key);
+    int32_t              size;
+    FileManager_Result   result;
+
+    if (entry == NULL || entry->Key != key || entry->Offset < 0) {
+        return FileManager_NO_FILE;
+    }
+    if (kv->Compacting && !FileManagerKV_hasSpace(kv->Files[kv->Active ^ 1], FILE_MANAGER_KV_RECORD_SIZE(0))) {
+        return FileManager_DENIED;
+    }
+    size   = FileManagerKV_build(kv, FileManagerKV_Deleted, key, NULL, 0);
+    result = FileManagerKV_append(kv->Files[kv->Active], kv->End, kv, size);
+    if (result != FileManager_OK) {
+        return result;
+    }
+    if (kv->Compacting && entry->ShadowOffset >= 0) {
+        FileManagerKV_append(kv->Files[kv->Active ^ 1], kv->ShadowEnd, kv, size);
+        kv->ShadowEnd += size;
+    }
+    kv->LiveBytes      -= FILE_MANAGER_KV_RECORD_SIZE(entry->Len);
+    kv->End            += size;
+    entry->Offset       = -1;
+    entry->ShadowOffset = -1;
+    entry->Len          = 0;
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief start Compaction, Truncate of other File is queued and Records are copied after its Header place
+ */
+static void FileManagerKV_startCompaction (FileManagerKV* kv) {
+    uint16_t i;
+    if (File_queueTruncate(kv->Files[kv->Active ^ 1], 0) != FileManager_OK) {
+        return;                                             ///// try again in next pass
+    }
+    for (i = 0; i < kv->IndexLen; i++) {
+        kv->Index[i].ShadowOffset = -1;
+    }
+    kv->ShadowEnd  = FILE_MANAGER_KV_HEADER_SIZE;
+    kv->CompactPos = 0;
+    kv->Compacting = 1;
+    kv->Finishing  = 0;
+}
+
+
+
+/**
+ * @brief queue copy of some live Records into other File (File_copy run in FileManager_handle, nothing here block),
+ *        Header is queued last so torn Compaction is ignored in mount
+ */
+static void FileManagerKV_compactStep (FileManagerKV* kv) {
+    FileManager*         shadow = kv->Files[kv->Active ^ 1];
+    FileManagerKV_Entry* entry;
+    uint32_t             generation;
+    int32_t              size;
+    uint16_t             i;
+    uint8_t              step;
+
+    for (step = 0; step < FILE_MANAGER_KV_COMPACT_STEP && kv->CompactPos < kv->IndexLen; kv->CompactPos++) {
+        entry = &kv->Index[kv->CompactPos];
+        if (entry->Key == FILE_MANAGER_KV_HEADER_KEY || entry->Offset < 0 || entry->ShadowOffset >= 0) {
+            continue;
+        }
+        size = FILE_MANAGER_KV_RECORD_SIZE(entry->Len);
+        if (entry->Offset + size > kv->Written || File_copy(kv->Files[kv->Active], shadow, entry->Offset, kv->ShadowEnd, size) != FileManager_OK) {
+            return;                                         ///// try again in next pass
+        }
+        entry->ShadowOffset = kv->ShadowEnd;
+        kv->ShadowEnd      += size;
+        step++;
+    }
+    if (kv->CompactPos < kv->IndexLen) {
+        return;
+    }
+    if (!kv->Finishing) {
+        generation = kv->Generation + 1;
+        size       = FileManagerKV_build(kv, FileManagerKV_Value, FILE_MANAGER_KV_HEADER_KEY, &generation, sizeof(generation));
+        if (FileManagerKV_append(shadow, 0, kv, size) == FileManager_OK) {
+            kv->Finishing = 1;
+        }
+        return;
+    }
+    if (Queue_available(&shadow->CommandQueue) == 0 && shadow->CommandHeaderInProcess.Len < 1) {
+        for (i = 0; i < kv->IndexLen; i++) {
+            kv->Index[i].Offset       = kv->Index[i].Offset >= 0 ? kv->Index[i].ShadowOffset : -1;
+            kv->Index[i].ShadowOffset = -1;
+        }
+        kv->Active    ^= 1;
+        kv->Generation++;
+        kv->End        = kv->ShadowEnd;
+        kv->Written    = kv->ShadowEnd;
+        kv->Compacting = 0;
+        kv->Finishing  = 0;
+    }
+}
+
+
+
+/**
+ * @brief Compaction step, called from FileManager_handle when one of Files is idle
+ *
+ * @param kv Address of FileManagerKV
+ */
+void FileManagerKV_handle (FileManagerKV* kv) {
+    FileManager* active = kv->Files[kv->Active];
+    int32_t      garbage;
+    if (Queue_available(&active->CommandQueue) == 0 && active->CommandHeaderInProcess.Len < 1) {
+        kv->Written = kv->End;
+    }
+    if (kv->Compacting) {
+        FileManagerKV_compactStep(kv);
+    }
+    else {
+        garbage = kv->End - (int32_t)FILE_MANAGER_KV_HEADER_SIZE - kv->LiveBytes;
+        if ((uint32_t)garbage > kv->CompactThreshold && garbage > kv->LiveBytes) {
+            FileManagerKV_startCompaction(kv);
+        }
+    }
+}
+
+
+
+static void FileManagerKV_onIdle (FileManager* file) {
+    FileManagerKV_handle((FileManagerKV*)FileManager_getArgs(file));
+}
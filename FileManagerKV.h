@@ -0,0 +1,87 @@
+/**
+ * @file FileManagerKV.h
+ * @author Reza Dehghan
+ * @brief Append Only Key-Value Record Store on top of two FileManager Files
+ *        every put append one Record, RAM Index keep Offset of last Record of each Key,
+ *        Compaction queue Truncate and File_copy of live Records into other File from onIdle of FileManager_handle,
+ *        give both Files a pending map (File_setPendingMap) so get can read Records which are still queued
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_KV_H_
+#define _FILE_MANAGER_KV_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FileManager.h"
+
+#define   FILE_MANAGER_KV_MAGIC            0xA5
+#define   FILE_MANAGER_KV_HEADER_KEY       0xFFFF       ///// reserved Key, also mark empty slot of Index
+#define   FILE_MANAGER_KV_COMPACT_STEP     4            ///// max Records copied in one FileManager_handle pass
+#define   FILE_MANAGER_KV_HEADER_SIZE      (sizeof(FileManagerKV_Record) + sizeof(uint32_t))
+
+typedef enum {
+    FileManagerKV_Value          = 0x00,
+    FileManagerKV_Deleted        = 0x01,
+} FileManagerKV_Flags;
+
+
+/**
+ * @brief Header of each Record in File, Value come after it
+ */
+typedef struct {
+    uint8_t                Magic;
+    uint8_t                Flags;
+    uint16_t               Key;
+    uint16_t               Len;
+    uint16_t               Check;       ///// Fletcher16 of Record (Check = 0) and Value
+} FileManagerKV_Record;
+
+
+typedef struct {
+    uint16_t               Key;
+    uint16_t               Len;
+    int32_t                Offset;       ///// Offset of last Record in active File, -1 -> deleted
+    int32_t                ShadowOffset; ///// Offset of Record in other File while Compaction, -1 -> not copied
+} FileManagerKV_Entry;
+
+
+typedef struct {
+    FileManager*           Files[2];
+    FileManagerKV_Entry*   Index;
+    uint8_t*               Buffer;
+    uint16_t               IndexLen;     ///// must be power of 2
+    uint16_t               BufferLen;    ///// max Record size, at least MaxSS for fast mount scan
+    uint32_t               Generation;
+    int32_t                End;          ///// append Offset in active File
+    int32_t                Written;      ///// Records before this Offset are written into File
+    int32_t                LiveBytes;
+    int32_t                ShadowEnd;
+    uint32_t               CompactThreshold;
+    uint16_t               CompactPos;
+    uint8_t                Active;
+    uint8_t                Compacting   : 1;
+    uint8_t                Finishing    : 1;
+    uint8_t                Reserved     : 6;
+} FileManagerKV;
+
+
+void               FileManagerKV_init     (FileManagerKV* kv, FileManager* file0, FileManager* file1, FileManagerKV_Entry* index, uint16_t indexLen, uint8_t* buffer, uint16_t bufferLen, uint32_t compactThreshold);
+FileManager_Result FileManagerKV_mount    (FileManagerKV* kv);
+FileManager_Result FileManagerKV_put      (FileManagerKV* kv, uint16_t key, const void* value, uint16_t len);
+FileManager_Result FileManagerKV_get      (FileManagerKV* kv, uint16_t key, void* value, uint16_t len);
+FileManager_Result FileManagerKV_remove   (FileManagerKV* kv, uint16_t key);
+int32_t            FileManagerKV_getLen   (FileManagerKV* kv, uint16_t key);
+void               FileManagerKV_handle   (FileManagerKV* kv);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _FILE_MANAGER_KV_H_ */
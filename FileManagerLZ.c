@@ -0,0 +1,185 @@
+#include "FileManagerLZ.h"
+#include <string.h>
+
+static uint16_t lzHashTable[1 << FILE_MANAGER_LZ_HASH_BITS];
+
+
+
+static uint32_t FileManagerLZ_read32 (const uint8_t* p) {
+    uint32_t val;
+    memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+static uint16_t FileManagerLZ_hash (uint32_t val) {
+    return (uint16_t)((val * 2654435761u) >> (32 - FILE_MANAGER_LZ_HASH_BITS));
+}
+
+
+
+/**
+ * @brief write length extension Bytes (255, 255, ..., rest)
+ * @return uint8_t* next out position, NULL if dst is full
+ */
+static uint8_t* FileManagerLZ_writeLen (uint8_t* op, uint8_t* oend, int32_t len) {
+    while (len >= 255) {
+        if (op >= oend) {
+            return NULL;
+        }
+        *op++ = 255;
+        len  -= 255;
+    }
+    if (op >= oend) {
+        return NULL;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+
+
+/**
+ * @brief write one Sequence: token, literals and (if matchLen > 0) offset
+ * @return uint8_t* next out position, NULL if dst is full
+ */
+static uint8_t* FileManagerLZ_writeSequence (uint8_t* op, uint8_t* oend, const uint8_t* literal, int32_t literalLen, uint16_t offset, int32_t matchLen) {
+    uint8_t* token = op++;
+    int32_t  ml    = matchLen > 0 ? matchLen - FILE_MANAGER_LZ_MIN_MATCH : 0;
+    if (token >= oend) {
+        return NULL;
+    }
+    *token = (uint8_t)(((literalLen < 15 ? literalLen : 15) << 4) | (ml < 15 ? ml : 15));
+    if (literalLen >= 15 && (op = FileManagerLZ_writeLen(op, oend, literalLen - 15)) == NULL) {
+        return NULL;
+    }
+    if (op + literalLen > oend) {
+        return NULL;
+    }
+    memcpy(op, literal, literalLen);
+    op += literalLen;
+    if (matchLen > 0) {
+        if (op + 2 > oend) {
+            return NULL;
+        }
+        *op++ = (uint8_t)offset;
+        *op++ = (uint8_t)(offset >> 8);
+        if (ml >= 15 && (op = FileManagerLZ_writeLen(op, oend, ml - 15)) == NULL) {
+            return NULL;
+        }
+    }
+    return op;
+}
+
+
+
+/**
+ * @brief compress one Block
+ * 
+ * @param src    Address of raw Data
+ * @param srcLen Length of raw Data (<= FILE_MANAGER_LZ_MAX_BLOCK)
+ * @param dst    Address of out Buffer
+ * @param dstLen sizeof out Buffer
+ * @return int32_t compressed Length, -1 if it is not fit in dst
+ */
+int32_t FileManagerLZ_compress (const uint8_t* src, int32_t srcLen, uint8_t* dst, int32_t dstLen) {
+    uint8_t*  op     = dst;
+    uint8_t*  oend   = dst + dstLen;
+    int32_t   ip     = 0;
+    int32_t   anchor = 0;
+    int32_t   ref;
+    int32_t   matchLen;
+    uint32_t  seq;
+    uint16_t  h;
+
+    if (srcLen > FILE_MANAGER_LZ_MAX_BLOCK) {
+        return -1;
+    }
+    memset(lzHashTable, 0, sizeof(lzHashTable));
+    while (ip + FILE_MANAGER_LZ_MIN_MATCH <= srcLen) {
+        seq            = FileManagerLZ_read32(src + ip);
+        h              = FileManagerLZ_hash(seq);
+        ref            = (int32_t)lzHashTable[h] - 1;
+        lzHashTable[h] = (uint16_t)(ip + 1);
+        if (ref < 0 || FileManagerLZ_read32(src + ref) != seq) {
+            ip++;
+            continue;
+        }
+        matchLen = FILE_MANAGER_LZ_MIN_MATCH;
+        while (ip + matchLen < srcLen && src[ref + matchLen] == src[ip + matchLen]) {
+            matchLen++;
+        }
+        op = FileManagerLZ_writeSequence(op, oend, src + anchor, ip - anchor, (uint16_t)(ip - ref), matchLen);
+        if (op == NULL) {
+            return -1;
+        }
+        ip    += matchLen;
+        anchor = ip;
+    }
+    op = FileManagerLZ_writeSequence(op, oend, src + anchor, srcLen - anchor, 0, 0);
+    return op == NULL ? -1 : (int32_t)(op - dst);
+}
+
+
+
+/**
+ * @brief decompress one Block
+ * 
+ * @param src    Address of compressed Data
+ * @param srcLen Length of compressed Data
+ * @param dst    Address of out Buffer
+ * @param dstLen sizeof out Buffer
+ * @return int32_t raw Length, -1 if Data is corrupt or not fit in dst
+ */
+int32_t FileManagerLZ_decompress (const uint8_t* src, int32_t srcLen, uint8_t* dst, int32_t dstLen) {
+    const uint8_t* ip   = src;
+    const uint8_t* iend = src + srcLen;
+    uint8_t*       op   = dst;
+    uint8_t*       oend = dst + dstLen;
+    const uint8_t* match;
+    int32_t        len;
+    uint8_t        token;
+
+    while (ip < iend) {
+        token = *ip++;
+        len   = token >> 4;
+        if (len == 15) {
+            do {
+                if (ip >= iend) {
+                    return -1;
+                }
+                len += *ip;
+            } while (*ip++ == 255);
+        }
+        if (ip + len > iend || op + len > oend) {
+            return -1;
+        }
+        memcpy(op, ip, len);
+        ip += len;
+        op += len;
+        if (ip >= iend) {
+            break;                                          ///// last Sequence has only literals
+        }
+        if (ip + 2 > iend) {
+            return -1;
+        }
+        match = op - (ip[0] | (ip[1] << 8));
+        ip   += 2;
+        len   = token & 0x0F;
+        if (len == 15) {
+            do {
+                if (ip >= iend) {
+                    return -1;
+                }
+                len += *ip;
+            } while (*ip++ == 255);
+        }
+        len += FILE_MANAGER_LZ_MIN_MATCH;
+        if (match < dst || match >= op || op + len > oend) {
+            return -1;
+        }
+        while (len-- > 0) {
+            *op++ = *match++;                               ///// Byte copy, match can overlap out
+        }
+    }
+    return (int32_t)(op - dst);
+}
@@ -0,0 +1,32 @@
+/**
+ * @file FileManagerLZ.h
+ * @author Reza Dehghan
+ * @brief small LZ77 Block Compressor (LZ4 like Sequences), each Block decode alone
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_LZ_H_
+#define _FILE_MANAGER_LZ_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define   FILE_MANAGER_LZ_HASH_BITS        10           ///// Hash table is (1 << HASH_BITS) * 2 Bytes static RAM
+#define   FILE_MANAGER_LZ_MIN_MATCH        4
+#define   FILE_MANAGER_LZ_MAX_BLOCK        0xFFFF       ///// Offsets are 16 bit
+
+int32_t FileManagerLZ_compress   (const uint8_t* src, int32_t srcLen, uint8_t* dst, int32_t dstLen);
+int32_t FileManagerLZ_decompress (const uint8_t* src, int32_t srcLen, uint8_t* dst, int32_t dstLen);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _FILE_MANAGER_LZ_H_ */
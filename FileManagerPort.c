@@ -1,5 +1,10 @@
 #include "FileManagerPort.h"
 
+/* Address/Size functions of driver table with FileManager types, old port with int32_t/uint32_t version give conflicting types error */
+FileManager_Result FileManager_userLseek    (FileManager* file, FileManager_Addr addr);
+FileManager_Size   FileManager_userGetSize  (FileManager* file);
+FileManager_Addr   FileManager_userPhysical (FileManager* file);
+
 const FileManager_Driver myFileManagerDriver = {
     FileManager_userOpen,
     FileManager_userWrite,
@@ -13,18 +18,61 @@ const FileManager_Driver myFileManagerDriver = {
     FileManager_userBSP_SdDetect,
     FileManager_userUnLink,
     FileManager_userGetTimestamp,
+    FileManager_userTruncate,
+    FileManager_userSync,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    FileManager_userPhysical,
 };
 
  const FileManager_Config myFileConfig = {
     _MAX_SS,
 };
 
-FileManager_Result FileManager_userErase (FileManager* file) {
+FileManager_Result FileManager_userTruncate (FileManager* file) {
     return (FileManager_Result) f_truncate (file->Context);
 }
 
+FileManager_Result FileManager_userSync (FileManager* file) {
+    return (FileManager_Result) f_sync (file->Context);
+}
+
+FileManager_Addr FileManager_userPhysical (FileManager* file) {
+    FIL*    fil        = (FIL*) file->Context;
+    FATFS*  fs         = fil->obj.fs;
+    uint8_t contiguous = 0;
+    UINT    sectorSize = _MAX_SS;
+#if _USE_FASTSEEK
+    DWORD   map[4];                                  ///// size, one fragment (count, cluster), end -> File is contiguous
+    DWORD*  cltbl      = fil->cltbl;
+#endif
+    if (fil->obj.sclust < 2) {
+        return -1;                                   ///// File has no cluster yet
+    }
+#if _MAX_SS != _MIN_SS
+    sectorSize = fs->ssize;
+#endif
+#if _FS_EXFAT
+    contiguous = fil->obj.stat == 2;                 ///// exFAT File without chain on FAT (f_expand)
+#endif
+#if _USE_FASTSEEK
+    if (!contiguous) {
+        map[0]     = 4;
+        fil->cltbl = map;
+        contiguous = f_lseek(fil, CREATE_LINKMAP) == FR_OK && map[0] == 4;
+        fil->cltbl = cltbl;                          ///// File with cltbl can not grow
+    }
+#endif
+    if (!contiguous) {
+        return -1;                                   ///// fragmented (or not known) File is not aligned
+    }
+    return (FileManager_Addr)(fs->database + (DWORD)(fil->obj.sclust - 2) * fs->csize) * sectorSize;
+}
+
 FileManager_Result FileManager_userOpen (FileManager* file, uint8_t* path, FileManager_OpenMethod openMethod) {
-    return (FileManager_Result) f_open (file->Context, (const TCHAR*)file->Path, openMethod);
+    return (FileManager_Result) f_open (file->Context, (const TCHAR*)path, openMethod);
 }
 
 FileManager_Result FileManager_userWrite (FileManager* file , void* data, int32_t len) {
@@ -36,16 +84,21 @@ FileManager_Result FileManager_userRead (FileManager* file, void* data, int32_t
 }
 
 
-FileManager_Result FileManager_userMount (FileManager_MountMethod mountStatus) {
-    return (FileManager_Result) f_mount (&SDFatFS, SDPath, mountStatus);
+FileManager_Result FileManager_userMount (FileManager_Volume* volume, FileManager_MountMethod mountStatus) {
+    FileManager_FatFsVolume* fatFsVolume = (FileManager_FatFsVolume*) volume->Context;
+    if (fatFsVolume == NULL) {
+        return (FileManager_Result) f_mount (&SDFatFS, SDPath, mountStatus);
+    }
+    return (FileManager_Result) f_mount (fatFsVolume->Fs, fatFsVolume->Path, mountStatus);
 }
 
 
-FileManager_Result FileManager_userUnMount (void) {
-    return (FileManager_Result) f_mount (0, SDPath, 0);
+FileManager_Result FileManager_userUnMount (FileManager_Volume* volume) {
+    FileManager_FatFsVolume* fatFsVolume = (FileManager_FatFsVolume*) volume->Context;
+    return (FileManager_Result) f_mount (0, fatFsVolume == NULL ? SDPath : fatFsVolume->Path, 0);
 }
 
-FileManager_Result FileManager_userLseek (FileManager* file, int32_t addr) {
+FileManager_Result FileManager_userLseek (FileManager* file, FileManager_Addr addr) {
     return (FileManager_Result) f_lseek (file->Context, addr);
 }
 
@@ -53,8 +106,12 @@ FileManager_Result FileManager_userClose (FileManager* file){
     return (FileManager_Result) f_close (file->Context);
 }
 
-uint8_t FileManager_userBSP_SdDetect (void) {
-    return (uint8_t) BSP_SD_IsDetected();
+uint8_t FileManager_userBSP_SdDetect (FileManager_Volume* volume) {
+    FileManager_FatFsVolume* fatFsVolume = (FileManager_FatFsVolume*) volume->Context;
+    if (fatFsVolume == NULL) {
+        return (uint8_t) BSP_SD_IsDetected();
+    }
+    return fatFsVolume->IsDetected == NULL ? 1 : fatFsVolume->IsDetected();
 }
 
 uint8_t FileManager_userIsOpen (FileManager* file) {
@@ -63,7 +120,7 @@ uint8_t FileManager_userIsOpen (FileManager* file) {
     return result;
 }
 
-uint32_t FileManager_userGetSize (FileManager* file) {
+FileManager_Size FileManager_userGetSize (FileManager* file) {
     return f_size((FIL*)file->Context);    
 }
 
@@ -4,27 +4,38 @@
 #ifndef _FILE_MANAGER_PORT_H_
 #define _FILE_MANAGER_PORT_H_
 
-#ifdef _cplusplus
+#ifdef __cplusplus
 extern "C" {
 #endif
 
 #include "fatfs.h"
 #include "FileManager.h"
 
+/**
+ * @brief Context of one FatFs volume (pass it to FileManager_addVolume), NULL Context -> SDFatFS/SDPath
+ */
+typedef struct {
+    FATFS*                 Fs;
+    const TCHAR*           Path;
+    uint8_t              (*IsDetected) (void);      ///// detect pin of device, NULL -> always detected
+} FileManager_FatFsVolume;
+
 FileManager_Result    FileManager_userOpen             (FileManager* file, uint8_t* path, FileManager_OpenMethod openMethod);
 FileManager_Result    FileManager_userWrite            (FileManager* file, void* data, int32_t len);
 FileManager_Result    FileManager_userRead             (FileManager* file, void* data, int32_t len);
-FileManager_Result    FileManager_userMount            (FileManager_MountMethod mountMethod);
-FileManager_Result    FileManager_userUnMount          (void);
-FileManager_Result    FileManager_userLseek            (FileManager* file, int32_t addr);
+FileManager_Result    FileManager_userMount            (FileManager_Volume* volume, FileManager_MountMethod mountMethod);
+FileManager_Result    FileManager_userUnMount          (FileManager_Volume* volume);
+FileManager_Result    FileManager_userLseek            (FileManager* file, FileManager_Addr addr);
 FileManager_Result    FileManager_userClose            (FileManager* file);
 FileManager_Result    FileManager_userSync             (FileManager* file);
 uint8_t               FileManager_userIsOpen           (FileManager* file);
-uint32_t              FileManager_userGetSize          (FileManager* file);
+FileManager_Size      FileManager_userGetSize          (FileManager* file);
 FileManager_Result    FileManager_userDelete           (uint8_t* path);
-uint8_t               FileManager_userBSP_SdDetect     (void);
+uint8_t               FileManager_userBSP_SdDetect     (FileManager_Volume* volume);
 FileManager_Result    FileManager_userUnLink           (uint8_t* path);
 FileManager_Timestamp FileManager_userGetTimestamp     (void);
+FileManager_Result    FileManager_userTruncate         (FileManager* file);
+FileManager_Addr      FileManager_userPhysical         (FileManager* file);
 
 
 
@@ -0,0 +1,379 @@
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64                                ///// 64-bit off_t for Files larger than 2GB on 32-bit hosts
+#endif
+#include "FileManagerPortPosix.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if FILE_MANAGER_POSIX_USE_IO_URING
+#include <liburing.h>
+#endif
+
+const FileManager_Driver posixFileManagerDriver = {
+    FileManager_posixOpen,
+    FileManager_posixWrite,
+    FileManager_posixRead,
+    FileManager_posixMount,
+    FileManager_posixUnMount,
+    FileManager_posixLseek,
+    FileManager_posixClose,
+    FileManager_posixIsOpen,
+    FileManager_posixGetSize,
+    FileManager_posixIsDetected,
+    FileManager_posixUnLink,
+    FileManager_posixGetTimestamp,
+    FileManager_posixTruncate,
+    FileManager_posixSync,
+    FileManager_posixMap,
+    FileManager_posixUnMap,
+    NULL,
+    NULL,
+    NULL,
+};
+
+const FileManager_Driver posixAsyncFileManagerDriver = {
+    FileManager_posixOpen,
+    FileManager_posixWrite,
+    FileManager_posixRead,
+    FileManager_posixMount,
+    FileManager_posixUnMount,
+    FileManager_posixLseek,
+    FileManager_posixClose,
+    FileManager_posixIsOpen,
+    FileManager_posixGetSize,
+    FileManager_posixIsDetected,
+    FileManager_posixUnLink,
+    FileManager_posixGetTimestamp,
+    FileManager_posixTruncate,
+    FileManager_posixSync,
+    FileManager_posixMap,
+    FileManager_posixUnMap,
+    FileManager_posixSubmit,
+    FileManager_posixPoll,
+    NULL,
+};
+
+const FileManager_Config posixFileConfig = {
+    FILE_MANAGER_POSIX_SECTOR,
+};
+
+#define POSIX_FIL(file)   ((FileManager_PosixFil*)(file)->Context)
+
+
+
+/**
+ * @brief convert errno into FileManager_Result
+ */
+static FileManager_Result FileManager_posixResult (int err) {
+    switch (err) {
+        case 0:       return FileManager_OK;
+        case ENOENT:  return FileManager_NO_FILE;
+        case ENOTDIR: return FileManager_NO_PATH;
+        case EACCES:
+        case EPERM:   return FileManager_DENIED;
+        case EEXIST:  return FileManager_EXIST;
+        case EBADF:   return FileManager_INVALID_OBJECT;
+        case EROFS:   return FileManager_WRITE_PROTECTED;
+        case EMFILE:
+        case ENFILE:  return FileManager_TOO_MANY_OPEN_FILES;
+        case ENOMEM:  return FileManager_NOT_ENOUGH_CORE;
+        case EINVAL:  return FileManager_INVALID_PARAMETER;
+        default:      return FileManager_DISK_ERR;
+    }
+}
+
+
+
+FileManager_Result FileManager_posixOpen (FileManager* file, uint8_t* path, FileManager_OpenMethod openMethod) {
+    int flags = 0;
+    if ((openMethod & FileManager_Read) && (openMethod & FileManager_Write)) {
+        flags = O_RDWR;
+    }
+    else {
+        flags = (openMethod & FileManager_Write) ? O_WRONLY : O_RDONLY;
+    }
+    if (openMethod & (FileManager_OpenAlways | FileManager_CreateAlways | FileManager_CreateNew)) {
+        flags |= O_CREAT;
+    }
+    if (openMethod & FileManager_CreateAlways) {
+        flags |= O_TRUNC;
+    }
+    if (openMethod & FileManager_CreateNew) {
+        flags |= O_EXCL;
+    }
+    POSIX_FIL(file)->Fd = open((const char*)path, flags | O_CLOEXEC, 0644);
+    if (POSIX_FIL(file)->Fd < 0) {
+        return FileManager_posixResult(errno);
+    }
+    if ((openMethod & FileManager_OpenAppend) == FileManager_OpenAppend) {
+        lseek(POSIX_FIL(file)->Fd, 0, SEEK_END);
+    }
+    return FileManager_OK;
+}
+
+FileManager_Result FileManager_posixWrite (FileManager* file, void* data, int32_t len) {
+    ssize_t done;
+    file->PendingByte = 0;
+    while ((int32_t)file->PendingByte < len) {
+        done = write(POSIX_FIL(file)->Fd, (uint8_t*)data + file->PendingByte, len - file->PendingByte);
+        if (done < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return FileManager_posixResult(errno);
+        }
+        file->PendingByte += done;
+    }
+    return FileManager_OK;
+}
+
+FileManager_Result FileManager_posixRead (FileManager* file, void* data, int32_t len) {
+    ssize_t done;
+    file->PendingByte = 0;
+    while ((int32_t)file->PendingByte < len) {
+        done = read(POSIX_FIL(file)->Fd, (uint8_t*)data + file->PendingByte, len - file->PendingByte);
+        if (done < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return FileManager_posixResult(errno);
+        }
+        if (done == 0) {
+            break;                                          ///// end of File
+        }
+        file->PendingByte += done;
+    }
+    return FileManager_OK;
+}
+
+FileManager_Result FileManager_posixMount (FileManager_Volume* volume, FileManager_MountMethod mountMethod) {
+    (void)volume;
+    (void)mountMethod;
+    return FileManager_OK;
+}
+
+FileManager_Result FileManager_posixUnMount (FileManager_Volume* volume) {
+    (void)volume;
+    return FileManager_OK;
+}
+
+FileManager_Result FileManager_posixLseek (FileManager* file, FileManager_Addr addr) {
+    return lseek(POSIX_FIL(file)->Fd, addr, SEEK_SET) < 0 ? FileManager_posixResult(errno) : FileManager_OK;
+}
+
+FileManager_Result FileManager_posixClose (FileManager* file) {
+    int result = close(POSIX_FIL(file)->Fd);
+    POSIX_FIL(file)->Fd = -1;
+    return result < 0 ? FileManager_posixResult(errno) : FileManager_OK;
+}
+
+FileManager_Result FileManager_posixSync (FileManager* file) {
+    return fdatasync(POSIX_FIL(file)->Fd) < 0 ? FileManager_posixResult(errno) : FileManager_OK;
+}
+
+FileManager_Result FileManager_posixTruncate (FileManager* file) {
+    off_t pos = lseek(POSIX_FIL(file)->Fd, 0, SEEK_CUR);
+    if (pos < 0 || ftruncate(POSIX_FIL(file)->Fd, pos) < 0) {
+        return FileManager_posixResult(errno);
+    }
+    return FileManager_OK;
+}
+
+uint8_t FileManager_posixIsOpen (FileManager* file) {
+    return POSIX_FIL(file)->Fd >= 0 ? 1 : 0;
+}
+
+FileManager_Size FileManager_posixGetSize (FileManager* file) {
+    struct stat st;
+    if (fstat(POSIX_FIL(file)->Fd, &st) < 0) {
+        return 0;
+    }
+    return (FileManager_Size)st.st_size;
+}
+
+uint8_t FileManager_posixIsDetected (FileManager_Volume* volume) {
+    (void)volume;
+    return 1;
+}
+
+FileManager_Result FileManager_posixUnLink (uint8_t* path) {
+    return unlink((const char*)path) < 0 ? FileManager_posixResult(errno) : FileManager_OK;
+}
+
+FileManager_Timestamp FileManager_posixGetTimestamp (void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (FileManager_Timestamp)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+
+
+/**
+ * @brief Map part of File, mapping is at least FILE_MANAGER_POSIX_MAP_CHUNK Bytes and
+ *        next windows of a sequential scan use same mapping
+ */
+FileManager_Result FileManager_posixMap (FileManager* file, FileManager_Addr addr, int32_t len, const uint8_t** view) {
+    FileManager_PosixFil* fil  = POSIX_FIL(file);
+    long                  page = sysconf(_SC_PAGESIZE);
+    FileManager_Addr      base;
+    size_t                mapLen;
+    struct stat           st;
+
+    if (fil->Map != NULL && addr >= fil->MapAddr && (size_t)(addr - fil->MapAddr) + len <= fil->MapLen) {
+        *view = fil->Map + (addr - fil->MapAddr);
+        return FileManager_OK;
+    }
+    FileManager_posixUnMap(file);
+    if (fstat(fil->Fd, &st) < 0) {
+        return FileManager_posixResult(errno);
+    }
+    if ((off_t)addr + len > st.st_size) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    base   = addr - (addr % page);
+    mapLen = (size_t)(addr - base) + len;
+    if (mapLen < FILE_MANAGER_POSIX_MAP_CHUNK) {
+        mapLen = FILE_MANAGER_POSIX_MAP_CHUNK;
+    }
+    if ((off_t)base + (off_t)mapLen > st.st_size) {
+        mapLen = st.st_size - base;
+    }
+    fil->Map = mmap(NULL, mapLen, PROT_READ, MAP_SHARED, fil->Fd, base);
+    if (fil->Map == MAP_FAILED) {
+        fil->Map = NULL;
+        return FileManager_posixResult(errno);
+    }
+    madvise(fil->Map, mapLen, MADV_SEQUENTIAL);
+    madvise(fil->Map, mapLen, MADV_WILLNEED);
+    fil->MapLen  = mapLen;
+    fil->MapAddr = base;
+    *view        = fil->Map + (addr - base);
+    return FileManager_OK;
+}
+
+FileManager_Result FileManager_posixUnMap (FileManager* file) {
+    FileManager_PosixFil* fil = POSIX_FIL(file);
+    if (fil->Map != NULL) {
+        munmap(fil->Map, fil->MapLen);
+        fil->Map    = NULL;
+        fil->MapLen = 0;
+    }
+    return FileManager_OK;
+}
+
+
+
+#if FILE_MANAGER_POSIX_USE_IO_URING
+static struct io_uring posixRing;
+static uint8_t         posixRingReady = 0;
+
+/**
+ * @brief setup one io_uring for all Files, call it once before FileManager_handle
+ */
+FileManager_Result FileManager_posixAsyncInit (void) {
+    int result;
+    if (posixRingReady) {
+        return FileManager_OK;
+    }
+    result = io_uring_queue_init(FILE_MANAGER_POSIX_RING_DEPTH, &posixRing, 0);
+    if (result < 0) {
+        return FileManager_posixResult(-result);
+    }
+    posixRingReady = 1;
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief queue one chunk on ring, it goes to kernel in next FileManager_posixPoll
+ *        so all chunks of one FileManager_handle pass are submitted with one syscall
+ */
+FileManager_Result FileManager_posixSubmit (FileManager* file, FileManager_AsyncOp* op) {
+    struct io_uring_sqe* sqe = io_uring_get_sqe(&posixRing);
+    if (sqe == NULL) {
+        io_uring_submit(&posixRing);
+        sqe = io_uring_get_sqe(&posixRing);
+        if (sqe == NULL) {
+            return FileManager_LOCKED;                      ///// ring is full, try in next pass
+        }
+    }
+    if (op->Mode == FileManager_WriteMode) {
+        io_uring_prep_write(sqe, POSIX_FIL(file)->Fd, op->Data, op->Len, op->Addr);
+    }
+    else {
+        io_uring_prep_read(sqe, POSIX_FIL(file)->Fd, op->Data, op->Len, op->Addr);
+    }
+    io_uring_sqe_set_data(sqe, op);
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief submit queued chunks and reap completions, wait = 1 -> block until at least one is complete
+ *        one ring serve all volumes of host, so volume is not used
+ */
+int32_t FileManager_posixPoll (FileManager_Volume* volume, uint8_t wait) {
+    struct io_uring_cqe* cqe;
+    FileManager_AsyncOp* op;
+    unsigned             head;
+    int32_t              count = 0;
+
+    (void)volume;
+    if (wait) {
+        io_uring_submit_and_wait(&posixRing, 1);
+    }
+    else {
+        io_uring_submit(&posixRing);
+    }
+    io_uring_for_each_cqe(&posixRing, head, cqe) {
+        op         = (FileManager_AsyncOp*)io_uring_cqe_get_data(cqe);
+        op->Result = cqe->res;
+        op->Done   = 1;
+        count++;
+    }
+    io_uring_cq_advance(&posixRing, count);
+    return count;
+}
+#else
+FileManager_Result FileManager_posixAsyncInit (void) {
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief without io_uring chunk is done here with pwrite/pread, FileManager_posixPoll has nothing to reap
+ */
+FileManager_Result FileManager_posixSubmit (FileManager* file, FileManager_AsyncOp* op) {
+    ssize_t done;
+    op->Result = 0;
+    while (op->Result < op->Len) {
+        if (op->Mode == FileManager_WriteMode) {
+            done = pwrite(POSIX_FIL(file)->Fd, (uint8_t*)op->Data + op->Result, op->Len - op->Result, op->Addr + op->Result);
+        }
+        else {
+            done = pread(POSIX_FIL(file)->Fd, (uint8_t*)op->Data + op->Result, op->Len - op->Result, op->Addr + op->Result);
+        }
+        if (done < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done <= 0) {
+            break;
+        }
+        op->Result += done;
+    }
+    op->Done = 1;
+    return FileManager_OK;
+}
+
+int32_t FileManager_posixPoll (FileManager_Volume* volume, uint8_t wait) {
+    (void)volume;
+    (void)wait;
+    return 0;
+}
+#endif
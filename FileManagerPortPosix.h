@@ -0,0 +1,70 @@
+/**
+ * @file FileManagerPortPosix.h
+ * @author Reza Dehghan
+ * @brief FileManager Driver for host build (Linux/POSIX), File Path is path in host FileSystem
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_PORT_POSIX_H_
+#define _FILE_MANAGER_PORT_POSIX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include "FileManager.h"
+
+#define   FILE_MANAGER_POSIX_SECTOR       4096
+#define   FILE_MANAGER_POSIX_MAP_CHUNK    (64UL << 20)   ///// Map at least this many Bytes, next windows need no new mmap
+#ifndef   FILE_MANAGER_POSIX_USE_IO_URING
+#define   FILE_MANAGER_POSIX_USE_IO_URING 0              ///// 1 -> Submit/Poll on io_uring (link with -luring), 0 -> pwrite/pread
+#endif
+#define   FILE_MANAGER_POSIX_RING_DEPTH   64
+
+/**
+ * @brief Context of one File (pass it as fil in FileManager_add)
+ */
+typedef struct {
+    int                    Fd;
+    uint8_t*               Map;
+    size_t                 MapLen;
+    FileManager_Addr       MapAddr;
+} FileManager_PosixFil;
+
+#define   FILE_MANAGER_POSIX_FIL_INIT     { -1, NULL, 0, 0 }
+
+FileManager_Result    FileManager_posixOpen             (FileManager* file, uint8_t* path, FileManager_OpenMethod openMethod);
+FileManager_Result    FileManager_posixWrite            (FileManager* file, void* data, int32_t len);
+FileManager_Result    FileManager_posixRead             (FileManager* file, void* data, int32_t len);
+FileManager_Result    FileManager_posixMount            (FileManager_Volume* volume, FileManager_MountMethod mountMethod);
+FileManager_Result    FileManager_posixUnMount          (FileManager_Volume* volume);
+FileManager_Result    FileManager_posixLseek            (FileManager* file, FileManager_Addr addr);
+FileManager_Result    FileManager_posixClose            (FileManager* file);
+FileManager_Result    FileManager_posixSync             (FileManager* file);
+FileManager_Result    FileManager_posixTruncate         (FileManager* file);
+uint8_t               FileManager_posixIsOpen           (FileManager* file);
+FileManager_Size      FileManager_posixGetSize          (FileManager* file);
+uint8_t               FileManager_posixIsDetected       (FileManager_Volume* volume);
+FileManager_Result    FileManager_posixUnLink           (uint8_t* path);
+FileManager_Timestamp FileManager_posixGetTimestamp     (void);
+FileManager_Result    FileManager_posixMap              (FileManager* file, FileManager_Addr addr, int32_t len, const uint8_t** view);
+FileManager_Result    FileManager_posixUnMap            (FileManager* file);
+FileManager_Result    FileManager_posixAsyncInit        (void);
+FileManager_Result    FileManager_posixSubmit           (FileManager* file, FileManager_AsyncOp* op);
+int32_t               FileManager_posixPoll             (FileManager_Volume* volume, uint8_t wait);
+
+
+extern  const FileManager_Driver posixFileManagerDriver;
+extern  const FileManager_Driver posixAsyncFileManagerDriver;    ///// need FILE_MANAGER_USE_ASYNC = 1 and FileManager_posixAsyncInit
+extern  const FileManager_Config posixFileConfig;
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _FILE_MANAGER_PORT_POSIX_H_ */
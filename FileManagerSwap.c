@@ -0,0 +1,94 @@
+#include "FileManagerSwap.h"
+#include <string.h>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__)
+#define FILE_MANAGER_BSWAP16(x)   __builtin_bswap16(x)
+#define FILE_MANAGER_BSWAP32(x)   __builtin_bswap32(x)
+#define FILE_MANAGER_BSWAP64(x)   __builtin_bswap64(x)
+#else
+#define FILE_MANAGER_BSWAP16(x)   ((uint16_t)(((x) >> 8) | ((x) << 8)))
+#define FILE_MANAGER_BSWAP32(x)   ((((x) & 0xFF) << 24) | (((x) & 0xFF00) << 8) | (((x) >> 8) & 0xFF00) | ((x) >> 24))
+#define FILE_MANAGER_BSWAP64(x)   (((uint64_t)FILE_MANAGER_BSWAP32((uint32_t)(x)) << 32) | FILE_MANAGER_BSWAP32((uint32_t)((x) >> 32)))
+#endif
+
+
+
+/**
+ * @brief swap 16 Bytes (16/size elements) in each step, return elements which are done
+ */
+static int32_t FileManagerSwap_vector (uint8_t* dst, const uint8_t* src, int32_t count, uint8_t size) {
+    int32_t done = 0;
+#if defined(__SSSE3__)
+    __m128i mask = size == 2 ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14) :
+                   size == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12) :
+                               _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    while (count - done >= 16 / size) {
+        _mm_storeu_si128((__m128i*)(dst + done * size), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + done * size)), mask));
+        done += 16 / size;
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t val;
+    while (count - done >= 16 / size) {
+        val = vld1q_u8(src + done * size);
+        val = size == 2 ? vrev16q_u8(val) : size == 4 ? vrev32q_u8(val) : vrev64q_u8(val);
+        vst1q_u8(dst + done * size, val);
+        done += 16 / size;
+    }
+#else
+    (void)dst;
+    (void)src;
+    (void)count;
+    (void)size;
+#endif
+    return done;
+}
+
+
+
+/**
+ * @brief copy count elements of size Bytes from src into dst with Bytes of each element in reverse order (dst may be src)
+ * 
+ * @param dst   Address of output
+ * @param src   Address of input
+ * @param count Number of elements
+ * @param size  Bytes of element (1, 2, 4, 8), 1 -> plain copy
+ */
+void FileManagerSwap_copy (uint8_t* dst, const uint8_t* src, int32_t count, uint8_t size) {
+    int32_t  i;
+    uint16_t val16;
+    uint32_t val32;
+    uint64_t val64;
+
+    if (size < 2) {
+        if (dst != src) {
+            memmove(dst, src, count);
+        }
+        return;
+    }
+    i = FileManagerSwap_vector(dst, src, count, size);
+    for (; i < count; i++) {
+        switch (size) {
+            case 2:
+                memcpy(&val16, src + i * 2, 2);
+                val16 = FILE_MANAGER_BSWAP16(val16);
+                memcpy(dst + i * 2, &val16, 2);
+                break;
+            case 4:
+                memcpy(&val32, src + i * 4, 4);
+                val32 = FILE_MANAGER_BSWAP32(val32);
+                memcpy(dst + i * 4, &val32, 4);
+                break;
+            default:
+                memcpy(&val64, src + i * 8, 8);
+                val64 = FILE_MANAGER_BSWAP64(val64);
+                memcpy(dst + i * 8, &val64, 8);
+                break;
+        }
+    }
+}
@@ -0,0 +1,27 @@
+/**
+ * @file FileManagerSwap.h
+ * @author Reza Dehghan
+ * @brief Byte swap of 16/32/64bit element arrays, pshufb (SSSE3) or NEON rev on host build, bswap word loop (REV on Cortex-M) on MCU
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_SWAP_H_
+#define _FILE_MANAGER_SWAP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+void FileManagerSwap_copy (uint8_t* dst, const uint8_t* src, int32_t count, uint8_t size);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _FILE_MANAGER_SWAP_H_ */
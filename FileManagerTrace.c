@@ -0,0 +1,164 @@
+#include "FileManagerTrace.h"
+
+static FileManagerTrace* activeTrace = NULL;
+
+
+
+/**
+ * @brief write Record into trace Buffer, Buffer is queued into trace File when it is full
+ */
+static void FileManagerTrace_onCapture (FileManager* file, const FileManager_CommandHeader* command) {
+    FileManagerTrace*       trace = activeTrace;
+    FileManagerTrace_Record record;
+    uint8_t                 i;
+
+    if (trace == NULL) {
+        return;
+    }
+    for (i = 0; i < trace->FileCount && trace->Files[i] != file; i++) {
+    }
+    if (i == trace->FileCount) {
+        return;
+    }
+    if (trace->Used + FILE_MANAGER_TRACE_RECORD_SIZE > trace->BufferLen && FileManagerTrace_flush(trace) != FileManager_OK) {
+        trace->Dropped++;
+        return;
+    }
+    record.Time     = FileManager_getTimeStamp();
+    record.Addr     = command->Addr;
+    record.Len      = command->Len;
+    record.Mode     = command->Mode;
+    record.DataType = command->DataType;
+    record.File     = i;
+    FileManagerTrace_encode(&record, trace->Buffer + trace->Used);
+    trace->Used    += FILE_MANAGER_TRACE_RECORD_SIZE;
+    trace->Records++;
+}
+
+
+
+/**
+ * @brief pack Record into FILE_MANAGER_TRACE_RECORD_SIZE Bytes
+ */
+void FileManagerTrace_encode (const FileManagerTrace_Record* record, uint8_t* data) {
+    memcpy(data,      &record->Time, sizeof(record->Time));
+    memcpy(data + 4,  &record->Addr, sizeof(record->Addr));
+    memcpy(data + 12, &record->Len,  sizeof(record->Len));
+    data[16] = record->Mode;
+    data[17] = record->DataType;
+    data[18] = record->File;
+}
+
+
+
+/**
+ * @brief unpack Record of trace File
+ */
+void FileManagerTrace_decode (const uint8_t* data, FileManagerTrace_Record* record) {
+    memcpy(&record->Time, data,      sizeof(record->Time));
+    memcpy(&record->Addr, data + 4,  sizeof(record->Addr));
+    memcpy(&record->Len,  data + 12, sizeof(record->Len));
+    record->Mode     = data[16];
+    record->DataType = data[17];
+    record->File     = data[18];
+}
+
+
+
+/**
+ * @brief Blocking start of capture, trace File is erased and get Header, Files are added by FileManagerTrace_attach
+ *
+ * @param trace     Address of FileManagerTrace
+ * @param out       Address of trace File (it is not captured)
+ * @param buffer    Records are collected here and written together
+ * @param bufferLen Bytes of buffer (at least FILE_MANAGER_TRACE_RECORD_SIZE, WriteStream of out must hold it)
+ * @return FileManager_Result
+ */
+FileManager_Result FileManagerTrace_start (FileManagerTrace* trace, FileManager* out, uint8_t* buffer, uint16_t bufferLen) {
+    uint8_t            header[FILE_MANAGER_TRACE_HEADER_SIZE];
+    uint32_t           magic = FILE_MANAGER_TRACE_MAGIC;
+    FileManager_Result result;
+
+    if (bufferLen < FILE_MANAGER_TRACE_RECORD_SIZE) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    memset(trace, 0, sizeof(*trace));
+    trace->Out       = out;
+    trace->Buffer    = buffer;
+    trace->BufferLen = bufferLen;
+    memset(header, 0, sizeof(header));
+    memcpy(header, &magic, sizeof(magic));
+    header[4] = FILE_MANAGER_TRACE_VERSION;
+    header[5] = FILE_MANAGER_TRACE_RECORD_SIZE;
+    result = File_erase(out);
+    if (result == FileManager_OK) {
+        result = File_writeBlocking(out, 0, header, sizeof(header));
+    }
+    if (result == FileManager_OK) {
+        activeTrace = trace;
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief capture commands of File (it use onCapture of File)
+ *
+ * @param trace Address of FileManagerTrace
+ * @param file  Address of FileManager
+ * @return FileManager_Result FileManager_NOT_ENOUGH_CORE if FILE_MANAGER_TRACE_FILES Files are captured
+ */
+FileManager_Result FileManagerTrace_attach (FileManagerTrace* trace, FileManager* file) {
+    if (file == trace->Out) {
+        return FileManager_INVALID_PARAMETER;
+    }
+    if (trace->FileCount == FILE_MANAGER_TRACE_FILES) {
+        return FileManager_NOT_ENOUGH_CORE;
+    }
+    trace->Files[trace->FileCount++] = file;
+    File_onCapture(file, FileManagerTrace_onCapture);
+    return FileManager_OK;
+}
+
+
+
+/**
+ * @brief NonBlocking write of collected Records into trace File
+ *
+ * @param trace Address of FileManagerTrace
+ * @return FileManager_Result FileManager_DENIED if queue of trace File is full
+ */
+FileManager_Result FileManagerTrace_flush (FileManagerTrace* trace) {
+    FileManager_Result result;
+    if (trace->Used == 0) {
+        return FileManager_OK;
+    }
+    if (Stream_space(&trace->Out->WriteStream) < trace->Used || Queue_space(&trace->Out->CommandQueue) == 0) {
+        return FileManager_DENIED;
+    }
+    result = File_write(trace->Out, END_OF_FILE, trace->Buffer, trace->Used, FileManager_Var);
+    if (result == FileManager_OK) {
+        trace->Used = 0;
+    }
+    return result;
+}
+
+
+
+/**
+ * @brief stop capture of all Files and write last Records
+ *
+ * @param trace Address of FileManagerTrace
+ * @return FileManager_Result
+ */
+FileManager_Result FileManagerTrace_stop (FileManagerTrace* trace) {
+    uint8_t i;
+    for (i = 0; i < trace->FileCount; i++) {
+        File_onCapture(trace->Files[i], NULL);
+    }
+    if (activeTrace == trace) {
+        activeTrace = NULL;
+    }
+    return FileManagerTrace_flush(trace);
+}
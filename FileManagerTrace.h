@@ -0,0 +1,65 @@
+/**
+ * @file FileManagerTrace.h
+ * @author Reza Dehghan
+ * @brief Capture of queued commands into a compact binary trace File (time, Address, Length, Mode of each command),
+ *        tools/FileManagerReplay.c replay trace on host with other Buffer sizes and handle period
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_TRACE_H_
+#define _FILE_MANAGER_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FileManager.h"
+
+#define   FILE_MANAGER_TRACE_MAGIC          0x52544D46   ///// "FMTR"
+#define   FILE_MANAGER_TRACE_VERSION        1
+#define   FILE_MANAGER_TRACE_FILES          8            ///// max captured Files
+#define   FILE_MANAGER_TRACE_HEADER_SIZE    8
+#define   FILE_MANAGER_TRACE_RECORD_SIZE    19           ///// packed Record in trace File
+
+
+/**
+ * @brief one queued command, Len is payload Length (Bytes in WriteStream for write commands)
+ */
+typedef struct {
+    uint32_t               Time;         ///// ms (GetTimestamp of default volume) when command is queued
+    int64_t                Addr;
+    int32_t                Len;
+    uint8_t                Mode;         ///// FileManager_Mode
+    uint8_t                DataType;
+    uint8_t                File;         ///// index of File in trace (order of FileManagerTrace_attach)
+} FileManagerTrace_Record;
+
+
+typedef struct {
+    FileManager*           Out;          ///// trace File
+    FileManager*           Files[FILE_MANAGER_TRACE_FILES];
+    uint8_t*               Buffer;       ///// Records wait here until Buffer is full
+    uint16_t               BufferLen;
+    uint16_t               Used;
+    uint32_t               Records;
+    uint32_t               Dropped;      ///// Records lost because queue of Out was full
+    uint8_t                FileCount;
+} FileManagerTrace;
+
+
+FileManager_Result FileManagerTrace_start   (FileManagerTrace* trace, FileManager* out, uint8_t* buffer, uint16_t bufferLen);
+FileManager_Result FileManagerTrace_attach  (FileManagerTrace* trace, FileManager* file);
+FileManager_Result FileManagerTrace_flush   (FileManagerTrace* trace);
+FileManager_Result FileManagerTrace_stop    (FileManagerTrace* trace);
+void               FileManagerTrace_encode  (const FileManagerTrace_Record* record, uint8_t* data);
+void               FileManagerTrace_decode  (const uint8_t* data, FileManagerTrace_Record* record);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* _FILE_MANAGER_TRACE_H_ */
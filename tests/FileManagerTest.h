@@ -0,0 +1,103 @@
+/**
+ * @file FileManagerTest.h
+ * @author Reza Dehghan
+ * @brief Check helpers and POSIX File setup of host tests, each test is one program which return 0 when all checks pass
+ *
+ *        build: gcc -I. tests/FileManagerTestDedupe.c FileManager.c FileManagerLZ.c FileManagerCRC.c FileManagerSwap.c
+ *               FileManagerPortPosix.c Queue.c StreamBuffer.c -o test && ./test
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef _FILE_MANAGER_TEST_H_
+#define _FILE_MANAGER_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "FileManagerPortPosix.h"
+
+#define   TEST_COMMANDS                   32
+#define   TEST_WRITE_STREAM               4096
+#define   TEST_READ_STREAM                4096
+
+#define   TEST_CHECK(cond)                do { testChecks++; if (!(cond)) { testFails++; printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+
+/**
+ * @brief File of test with its own Buffers on POSIX driver
+ */
+typedef struct {
+    FileManager            File;
+    FileManager_PosixFil   Fil;
+    FileManager_CommandHeader CommandQ[TEST_COMMANDS];
+    FileManager_CommandHeader ReadQ[4];
+    uint8_t                WriteStream[TEST_WRITE_STREAM];
+    uint8_t                ReadStream[TEST_READ_STREAM];
+} TestFile;
+
+
+static int testChecks = 0;
+static int testFails  = 0;
+
+
+/**
+ * @brief init driver once, File start empty
+ */
+static void Test_open (TestFile* test, const char* path, int commands) {
+    static uint8_t init = 0;
+    FileManager_PosixFil fil = FILE_MANAGER_POSIX_FIL_INIT;
+    if (!init) {
+        FileManager_Init(&posixFileManagerDriver);
+        init = 1;
+    }
+    unlink(path);
+    memset(test, 0, sizeof(*test));
+    test->Fil = fil;
+    FileManager_add(&test->File, &test->Fil, &posixFileConfig, (uint8_t*)path);
+    File_init(&test->File, (uint8_t*)test->CommandQ, (uint16_t)(commands * sizeof(FileManager_CommandHeader)), (uint8_t*)test->ReadQ, sizeof(test->ReadQ),
+              test->WriteStream, sizeof(test->WriteStream), test->ReadStream, sizeof(test->ReadStream));
+}
+
+
+/**
+ * @brief File has queued command or chunk in flight
+ */
+static int Test_busy (TestFile* test) {
+#if FILE_MANAGER_USE_ASYNC
+    if (test->File.AsyncCount > 0 || test->File.AsyncRead) {
+        return 1;
+    }
+#endif
+    return Queue_available(&test->File.CommandQueue) > 0 || test->File.CommandHeaderInProcess.Len > 0;
+}
+
+
+/**
+ * @brief run FileManager_handle until File has no queued command
+ */
+static void Test_drain (TestFile* test) {
+    int i;
+    for (i = 0; i < 1000000 && Test_busy(test); i++) {
+        FileManager_handle();
+    }
+    FileManager_handle();
+}
+
+
+static void Test_close (TestFile* test) {
+    Test_drain(test);
+    FileManager_remove(&test->File);
+    unlink((const char*)test->File.Path);
+}
+
+
+static int Test_result (const char* name) {
+    printf("%s: %d checks, %d failed\n", name, testChecks, testFails);
+    return testFails != 0;
+}
+
+#endif /* _FILE_MANAGER_TEST_H_ */
@@ -0,0 +1,78 @@
+/**
+ * @file FileManagerTestAlign.c
+ * @brief Aligned appends: held append is not Synced in middle of its command (SyncEveryCommand),
+ *        File which driver Physical can not place (fragmented) get no hold
+ */
+#include "FileManagerTest.h"
+
+#define   TEST_RUN          512
+#define   TEST_MAX_HOLD     60000
+
+static TestFile            test;
+static FileManager_Driver  driver;
+static FileManager_Addr    physical;
+
+static FileManager_Addr Test_physical (FileManager* file) {
+    (void)file;
+    return physical;
+}
+
+static void Test_handle (int count) {
+    int i;
+    for (i = 0; i < count; i++) {
+        FileManager_handle();
+    }
+}
+
+int main (void) {
+    static uint8_t data[TEST_RUN * 2];
+    int            i;
+
+    for (i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 3 + 5);
+    }
+
+    /* first run is written, rest of command is held without Sync */
+    Test_open(&test, "fmtest_align.bin", TEST_COMMANDS);
+    File_setSyncPolicy(&test.File, FileManager_SyncEveryCommand, 0);
+    File_setAlignment(&test.File, TEST_RUN, 0, TEST_MAX_HOLD);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, TEST_RUN + 88, FileManager_Var) == FileManager_OK);
+    Test_handle(20);
+    TEST_CHECK(test.File.CommandHeaderInProcess.Len == 88);
+    TEST_CHECK(test.File.Stats.BytesWritten == TEST_RUN);
+    TEST_CHECK(test.File.Stats.SyncCount == 0);
+    TEST_CHECK(test.File.FileStatus == FileManager_FileIsOpen);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data + TEST_RUN + 88, TEST_RUN - 88, FileManager_Var) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(test.File.Stats.BytesWritten == 2 * TEST_RUN);
+    TEST_CHECK(test.File.Stats.SyncCount == 2);
+    TEST_CHECK(test.File.Stats.HoldTimeouts == 0);
+    Test_close(&test);
+
+    /* fragmented File: driver Physical give -1, appends are written at once */
+    driver          = posixFileManagerDriver;
+    driver.Physical = Test_physical;
+    Test_open(&test, "fmtest_align.bin", TEST_COMMANDS);
+    FileManager_Init(&driver);
+    TEST_CHECK(File_writeBlocking(&test.File, 0, data, 100) == FileManager_OK);
+    File_setAlignment(&test.File, TEST_RUN, FILE_MANAGER_ALIGN_DISCOVER, TEST_MAX_HOLD);
+    physical = -1;
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, 50, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, 50, FileManager_Var) == FileManager_OK);
+    Test_handle(20);
+    TEST_CHECK(test.File.CommandHeaderInProcess.Len == 0);
+    TEST_CHECK(test.File.AlignPos == -1);
+
+    /* contiguous File: same appends are held */
+    physical = 4096;
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, 50, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, 50, FileManager_Var) == FileManager_OK);
+    Test_handle(20);
+    TEST_CHECK(test.File.CommandHeaderInProcess.Len == 50);       ///// first append place File, second wait for run
+    TEST_CHECK(test.File.AlignPos == 4096 + 250);
+    File_setAlignment(&test.File, 0, 0, 0);
+    Test_close(&test);
+    FileManager_Init(&posixFileManagerDriver);
+
+    return Test_result("align");
+}
@@ -0,0 +1,39 @@
+/**
+ * @file FileManagerTestArray.c
+ * @brief File_writeArray: array which does not fit in WriteStream is refused in host order and swapped order
+ *        (nothing is queued), arrays which fit are read back in host order
+ */
+#include "FileManagerTest.h"
+
+static TestFile test;
+
+int main (void) {
+    static uint8_t  fill[TEST_WRITE_STREAM];
+    uint32_t        values[64];
+    uint32_t        got[64];
+    uint32_t        lastId;
+    int             i;
+
+    for (i = 0; i < 64; i++) {
+        values[i] = 0x01020304u * (uint32_t)(i + 1);
+    }
+    Test_open(&test, "fmtest_array.bin", TEST_COMMANDS);
+    TEST_CHECK(File_write(&test.File, 1024, fill, TEST_WRITE_STREAM - 100, FileManager_Var) == FileManager_OK);
+    lastId = File_getLastId(&test.File);
+    TEST_CHECK(File_writeArrayU32(&test.File, 0, values, 64, FileManager_NativeEndian) == FileManager_NOT_ENOUGH_CORE);
+    TEST_CHECK(File_writeArrayU32(&test.File, 0, values, 64, FileManager_LittleEndian) == FileManager_NOT_ENOUGH_CORE);
+    TEST_CHECK(File_writeArrayU32(&test.File, 0, values, 64, FileManager_BigEndian) == FileManager_NOT_ENOUGH_CORE);
+    TEST_CHECK(File_getLastId(&test.File) == lastId);
+    TEST_CHECK(Queue_available(&test.File.CommandQueue) == 1);
+    Test_drain(&test);
+
+    TEST_CHECK(File_writeArrayU32(&test.File, 0, values, 32, FileManager_NativeEndian) == FileManager_OK);
+    TEST_CHECK(File_writeArrayU32(&test.File, 128, values + 32, 32, FileManager_BigEndian) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(File_readArrayU32Blocking(&test.File, 0, got, 32, FileManager_NativeEndian) == FileManager_OK);
+    TEST_CHECK(File_readArrayU32Blocking(&test.File, 128, got + 32, 32, FileManager_BigEndian) == FileManager_OK);
+    TEST_CHECK(memcmp(got, values, sizeof(values)) == 0);
+
+    Test_close(&test);
+    return Test_result("array");
+}
@@ -0,0 +1,160 @@
+/**
+ * @file FileManagerTestAsync.c
+ * @brief Async driver: overlapping writes of two commands are not in flight together and failed chunk is
+ *        submitted again, read after end of File and short read chunk give onRead only Bytes which were read,
+ *        test driver complete chunks newest first and can fail or cut them
+ *
+ *        build: add -DFILE_MANAGER_USE_ASYNC=1 to build line of FileManagerTest.h
+ */
+#include "FileManagerTest.h"
+
+#if FILE_MANAGER_USE_ASYNC
+
+static TestFile             test;
+static FileManager_Driver   driver;
+static FileManager_AsyncOp* deferred[FILE_MANAGER_ASYNC_DEPTH * 2];
+static int                  deferredCount;
+static int                  failNext;
+static int                  shortNext;
+static int                  errors;
+static int                  completes;
+static FileManager_Result   lastResult;
+static uint8_t              got[1000];
+static int32_t              gotLen;
+
+static FileManager_Result Test_submit (FileManager* file, FileManager_AsyncOp* op) {
+    deferred[deferredCount++] = op;
+    return FileManager_OK;
+}
+
+static int32_t Test_poll (FileManager_Volume* volume, uint8_t wait) {
+    static int           polls = 0;
+    FileManager_AsyncOp* op;
+    int32_t              count = 0;
+    if (!wait && ++polls % 4 != 0) {
+        return 0;                                                   ///// chunks of some passes stay in flight together
+    }
+    while (deferredCount > 0) {
+        op = deferred[--deferredCount];                             ///// newest chunk complete first
+        if (failNext > 0) {
+            failNext--;
+            op->Result = -5;
+            op->Done   = 1;
+        }
+        else {
+            FileManager_posixSubmit(&test.File, op);
+            if (shortNext > 0 && op->Result > 0) {
+                shortNext--;
+                op->Result /= 2;                                    ///// driver read only part of chunk
+            }
+        }
+        count++;
+    }
+    return count;
+}
+
+static void Test_onError (FileManager* file, FileManager_Result result, FileManager_Addr addr) {
+    errors++;
+}
+
+static void Test_onComplete (FileManager* file, FileManager_CommandHeader* command, FileManager_Result result) {
+    completes++;
+    lastResult = result;
+}
+
+static void Test_onRead (FileManager* file, Stream* stream, FileManager_CommandHeader* command) {
+    int32_t len = Stream_available(stream);
+    Stream_readBytes(stream, got + gotLen, len);
+    gotLen += len;
+}
+
+static void Test_read (FileManager_Addr addr, int32_t len) {
+    memset(got, 0, sizeof(got));
+    gotLen    = 0;
+    completes = 0;
+    errors    = 0;
+    TEST_CHECK(File_read(&test.File, addr, len) == FileManager_OK);
+    Test_drain(&test);
+}
+
+static void Test_reopen (void) {
+    Test_open(&test, "fmtest_async.bin", TEST_COMMANDS);
+    FileManager_Init(&driver);
+    File_setSyncPolicy(&test.File, FileManager_SyncExplicit, 0);
+    File_onError(&test.File, Test_onError);
+    File_onComplete(&test.File, Test_onComplete);
+    File_onRead(&test.File, Test_onRead);
+}
+
+static int Test_all (const uint8_t* data, int32_t len, uint8_t value) {
+    int32_t i;
+    for (i = 0; i < len && data[i] == value; i++) {
+    }
+    return i == len;
+}
+
+int main (void) {
+    static uint8_t ones[1000];
+    static uint8_t twos[1000];
+
+    memset(ones, 0x11, sizeof(ones));
+    memset(twos, 0x22, sizeof(twos));
+    driver        = posixAsyncFileManagerDriver;
+    driver.Submit = Test_submit;
+    driver.Poll   = Test_poll;
+    Test_reopen();
+
+    TEST_CHECK(File_write(&test.File, 0, ones, sizeof(ones), FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, 500, twos, sizeof(twos), FileManager_Var) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 500) == FileManager_OK && Test_all(got, 500, 0x11));
+    TEST_CHECK(File_readBlocking(&test.File, 500, got, 1000) == FileManager_OK && Test_all(got, 1000, 0x22));   ///// newer write win
+
+    completes = 0;
+    failNext  = FILE_MANAGER_ASYNC_RETRIES;
+    TEST_CHECK(File_write(&test.File, 2000, ones, sizeof(ones), FileManager_Var) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(errors == FILE_MANAGER_ASYNC_RETRIES && completes == 1 && lastResult == FileManager_OK);
+    TEST_CHECK(File_readBlocking(&test.File, 2000, got, 1000) == FileManager_OK && Test_all(got, 1000, 0x11));
+
+    errors    = 0;
+    completes = 0;
+    failNext  = FILE_MANAGER_ASYNC_RETRIES + 1;                     ///// Data is dropped only after last retry
+    TEST_CHECK(File_write(&test.File, 3000, twos, sizeof(twos), FileManager_Var) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(errors == FILE_MANAGER_ASYNC_RETRIES + 1 && completes == 1 && lastResult == FileManager_DISK_ERR);
+    TEST_CHECK(Stream_available(&test.File.WriteStream) == 0);
+    Test_close(&test);
+
+    /* reads: old Bytes of ReadStream are never given to onRead */
+    Test_reopen();
+    memset(test.ReadStream, 0xEE, sizeof(test.ReadStream));
+    TEST_CHECK(File_write(&test.File, 0, ones, 100, FileManager_Var) == FileManager_OK);
+    Test_drain(&test);
+    Test_read(0, 200);
+    TEST_CHECK(gotLen == 100 && Test_all(got, 100, 0x11));         ///// read is cut at end of File
+    TEST_CHECK(completes == 1 && lastResult == FileManager_OK && errors == 0);
+    Test_read(300, 50);
+    TEST_CHECK(gotLen == 0 && completes == 1 && lastResult == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, 100, twos, 900, FileManager_Var) == FileManager_OK);
+    Test_drain(&test);
+    shortNext = 1;
+    Test_read(0, 400);
+    TEST_CHECK(gotLen == 200 && Test_all(got, 100, 0x11) && Test_all(got + 100, 100, 0x22));   ///// short chunk end command
+    TEST_CHECK(completes == 1 && lastResult == FileManager_DISK_ERR && errors == 1);
+    Test_read(0, 1000);
+    TEST_CHECK(gotLen == 1000 && Test_all(got, 100, 0x11) && Test_all(got + 100, 900, 0x22));
+    TEST_CHECK(completes == 1 && lastResult == FileManager_OK);
+
+    Test_close(&test);
+    return Test_result("async");
+}
+
+#else
+
+int main (void) {
+    printf("async: build with -DFILE_MANAGER_USE_ASYNC=1\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/**
+ * @file FileManagerTestBlocking.c
+ * @brief File_readBlocking: read which cross end of File return FileManager_EOF with Bytes before end,
+ *        queued appends in pending map are Bytes of File (no FileManager_EOF)
+ */
+#include "FileManagerTest.h"
+
+static TestFile            test;
+static FileManager_Pending pending[8];
+
+int main (void) {
+    uint8_t data[150];
+    uint8_t got[100];
+    int     i;
+
+    for (i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7 + 1);
+    }
+    Test_open(&test, "fmtest_blocking.bin", TEST_COMMANDS);
+    TEST_CHECK(File_writeBlocking(&test.File, 0, data, 100) == FileManager_OK);
+
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 100) == FileManager_OK);
+    TEST_CHECK(memcmp(got, data, 100) == 0);
+    memset(got, 0, sizeof(got));
+    TEST_CHECK(File_readBlocking(&test.File, 50, got, 100) == FileManager_EOF);
+    TEST_CHECK(memcmp(got, data + 50, 50) == 0);
+    TEST_CHECK(File_readBlocking(&test.File, 100, got, 1) == FileManager_EOF);
+
+    File_setPendingMap(&test.File, pending, 8);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data + 100, 50, FileManager_Var) == FileManager_OK);
+    memset(got, 0, sizeof(got));
+    TEST_CHECK(File_readBlocking(&test.File, 50, got, 100) == FileManager_OK);   ///// queued append give last 50 Bytes
+    TEST_CHECK(memcmp(got, data + 50, 100) == 0);
+    TEST_CHECK(File_readBlocking(&test.File, 120, got, 40) == FileManager_EOF);
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 50, got, 100) == FileManager_OK);
+    TEST_CHECK(memcmp(got, data + 50, 100) == 0);
+
+    Test_close(&test);
+    return Test_result("blocking");
+}
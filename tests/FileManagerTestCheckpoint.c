@@ -0,0 +1,76 @@
+/**
+ * @file FileManagerTestCheckpoint.c
+ * @brief Checkpoints: Record count only after marker has written it, File_recover keep Bytes of unframed File after last Record
+ *        (clean Close), framed File lose only torn Frame
+ */
+#include "FileManagerTest.h"
+
+#define   TEST_SPACING      4096
+#define   TEST_CHUNK        700
+
+static TestFile test;
+static TestFile marker;
+
+static int      queued;
+
+static void Test_onComplete (FileManager* file, FileManager_CommandHeader* command, FileManager_Result result) {
+    (void)command;
+    (void)result;
+    if (Queue_available(&marker.File.CommandQueue) > 0) {
+        queued++;
+        TEST_CHECK(File_getCheckpoint(file) == 0);                      ///// Record is queued by Sync of this command, not written yet
+    }
+}
+
+static void Test_reopen (uint8_t framing) {
+    Test_open(&test, "fmtest_checkpoint.bin", TEST_COMMANDS);
+    Test_open(&marker, "fmtest_checkpoint.cp", TEST_COMMANDS);
+    File_setSyncPolicy(&test.File, FileManager_SyncEveryCommand, 0);
+    File_setFraming(&test.File, framing);
+    File_setCheckpoint(&test.File, &marker.File, TEST_SPACING);
+}
+
+int main (void) {
+    static uint8_t   data[TEST_CHUNK];
+    FileManager_Addr end = 0;
+    int              i;
+
+    for (i = 0; i < TEST_CHUNK; i++) {
+        data[i] = (uint8_t)(i * 11 + 3);
+    }
+
+    /* unframed File, clean Close: nothing is cut */
+    Test_reopen(0);
+    File_onComplete(&test.File, Test_onComplete);
+    for (i = 0; i < 10; i++) {
+        TEST_CHECK(File_write(&test.File, END_OF_FILE, data, TEST_CHUNK, FileManager_Var) == FileManager_OK);
+        Test_drain(&test);
+        Test_drain(&marker);
+    }
+    TEST_CHECK(queued == 1);
+    TEST_CHECK(File_getCheckpoint(&test.File) == 6 * TEST_CHUNK);
+    Test_drain(&marker);
+    TEST_CHECK(File_recover(&test.File, &marker.File, &end) == FileManager_OK);
+    TEST_CHECK(end == 10 * TEST_CHUNK);
+    TEST_CHECK(File_getSize(&test.File) == 10 * TEST_CHUNK);
+    TEST_CHECK(File_getCheckpoint(&test.File) == 6 * TEST_CHUNK);
+    Test_close(&marker);
+    Test_close(&test);
+
+    /* framed File: torn last Frame is cut, whole Frames after Record stay */
+    Test_reopen(1);
+    for (i = 0; i < 10; i++) {
+        TEST_CHECK(File_write(&test.File, END_OF_FILE, data, TEST_CHUNK, FileManager_Var) == FileManager_OK);
+        Test_drain(&test);
+        Test_drain(&marker);
+    }
+    end = File_getSize(&test.File);
+    TEST_CHECK(truncate("fmtest_checkpoint.bin", end - 10) == 0);
+    TEST_CHECK(File_recover(&test.File, &marker.File, &end) == FileManager_OK);
+    TEST_CHECK(end == 9 * (FileManager_Addr)(TEST_CHUNK + sizeof(FileManager_FrameHeader) + 4));
+    TEST_CHECK(File_getSize(&test.File) == (FileManager_Size)end);
+    Test_close(&marker);
+    Test_close(&test);
+
+    return Test_result("checkpoint");
+}
@@ -0,0 +1,77 @@
+/**
+ * @file FileManagerTestColLog.c
+ * @brief FileManagerColLog: init refuse scan Buffer smaller than Footer, float min/max (negative values and NaN) skip right Blocks
+ */
+#include "FileManagerTest.h"
+#include "FileManagerColLog.h"
+
+#define   TEST_BLOCK_SIZE   256
+
+static TestFile          test;
+static FileManagerColLog log;
+static uint32_t          block[TEST_BLOCK_SIZE / 4];
+static uint32_t          scan[(TEST_BLOCK_SIZE + TEST_BLOCK_SIZE / 4) / 4];
+static const uint8_t     types[2] = { FileManagerColLog_Int32, FileManagerColLog_Float };
+static int               matched;
+static int               wrong;
+
+static void Test_onScan (FileManagerColLog* colLog, uint32_t index, const void* values, const uint8_t* match, uint16_t count, void* args) {
+    const float* v = (const float*)values;
+    uint16_t     i;
+    (void)colLog;
+    (void)index;
+    (void)args;
+    for (i = 0; i < count; i++) {
+        matched += match[i];
+        wrong   += match[i] != (v[i] >= -2.0f && v[i] <= 2.0f);
+    }
+}
+
+int main (void) {
+    struct {
+        int32_t I;
+        float   F;
+    } record;
+    FileManagerColLog_Value lo;
+    FileManagerColLog_Value hi;
+    uint32_t                nan = 0x7FC00000;
+    int                     i;
+
+    Test_open(&test, "fmtest_collog.bin", TEST_COMMANDS);
+    TEST_CHECK(FileManagerColLog_init(&log, &test.File, types, 2, block, TEST_BLOCK_SIZE, scan, 16) == FileManager_INVALID_PARAMETER);
+    TEST_CHECK(FileManagerColLog_init(&log, &test.File, types, 2, block, TEST_BLOCK_SIZE, scan, sizeof(scan)) == FileManager_OK);
+    TEST_CHECK(log.Capacity == 28);
+
+    for (i = 0; i < 100; i++) {
+        record.I = i;
+        record.F = (float)(i - 50) * 0.5f;
+        if (i == 40) {
+            memcpy(&record.F, &nan, sizeof(record.F));     ///// NaN must not widen min/max of Block 1
+        }
+        TEST_CHECK(FileManagerColLog_append(&log, &record) == FileManager_OK);
+        Test_drain(&test);
+    }
+    TEST_CHECK(FileManagerColLog_flush(&log) == FileManager_OK);
+    Test_drain(&test);
+
+    lo.F = -2.0f;
+    hi.F = 2.0f;
+    TEST_CHECK(FileManagerColLog_scan(&log, 1, lo, hi, Test_onScan, NULL) == FileManager_OK);
+    TEST_CHECK(matched == 9);
+    TEST_CHECK(wrong == 0);
+    TEST_CHECK(log.Skipped == 3);
+
+    lo.F = -30.0f;
+    hi.F = -24.0f;                                           ///// only first Block
+    matched = 0;
+    TEST_CHECK(FileManagerColLog_scan(&log, 1, lo, hi, Test_onScan, NULL) == FileManager_OK);
+    TEST_CHECK(matched == 3 && log.Skipped == 3);
+
+    lo.I = 90;
+    hi.I = 200;
+    TEST_CHECK(FileManagerColLog_scan(&log, 0, lo, hi, NULL, NULL) == FileManager_OK);
+    TEST_CHECK(log.Skipped == 3);                            ///// only RAM Block
+
+    Test_close(&test);
+    return Test_result("collog");
+}
@@ -0,0 +1,58 @@
+/**
+ * @file FileManagerTestConst.c
+ * @brief Const write keep whole pointer in WriteStream (64bit host too) and is written without WriteStream Data,
+ *        mapped read which cross end of File is cut at end of File
+ */
+#include "FileManagerTest.h"
+
+static TestFile               test;
+static FileManager_Compress   compress;
+static uint8_t                block[256];
+static uint8_t                coded[256 + sizeof(FileManager_BlockHeader)];
+static FileManager_BlockIndex blocks[8];
+static uint8_t                table[3000];
+static uint8_t                got[3000];
+static int32_t                gotLen;
+
+static void Test_onRead (FileManager* file, Stream* stream, FileManager_CommandHeader* command) {
+    int32_t len = Stream_available(stream);
+    Stream_readBytes(stream, got + gotLen, len);
+    gotLen += len;
+}
+
+int main (void) {
+    int i;
+
+    for (i = 0; i < (int)sizeof(table); i++) {
+        table[i] = (uint8_t)(i * 13 + 1);
+    }
+    Test_open(&test, "fmtest_const.bin", TEST_COMMANDS);
+    File_onRead(&test.File, Test_onRead);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, table, sizeof(table), FileManager_Const) == FileManager_OK);
+    TEST_CHECK(Stream_available(&test.File.WriteStream) == sizeof(uint8_t*));
+    Test_drain(&test);
+    TEST_CHECK(File_getSize(&test.File) == sizeof(table));
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, sizeof(table)) == FileManager_OK && memcmp(got, table, sizeof(table)) == 0);
+
+    gotLen = 0;
+    TEST_CHECK(File_readMapped(&test.File, sizeof(table) - 100, 500) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(gotLen == 100 && memcmp(got, table + sizeof(table) - 100, 100) == 0);
+    gotLen = 0;
+    TEST_CHECK(File_readMapped(&test.File, sizeof(table) + 10, 50) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(gotLen == 0);
+    Test_close(&test);
+
+    Test_open(&test, "fmtest_const.bin", TEST_COMMANDS);           ///// Const on compressed File go into raw Block
+    File_onRead(&test.File, Test_onRead);
+    TEST_CHECK(File_setCompression(&test.File, &compress, block, sizeof(block), coded, sizeof(coded), blocks, 8) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, table, 1000, FileManager_Const) == FileManager_OK);
+    Test_drain(&test);
+    gotLen = 0;
+    TEST_CHECK(File_read(&test.File, 0, 1000) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(gotLen == 1000 && memcmp(got, table, 1000) == 0);
+    Test_close(&test);
+    return Test_result("const");
+}
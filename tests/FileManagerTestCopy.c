@@ -0,0 +1,65 @@
+/**
+ * @file FileManagerTestCopy.c
+ * @brief File_copyBlocking and File_copy on sync driver: each block is one driver Read and one driver Write
+ *        (not MaxSS pieces), copy stop at end of src
+ */
+#include "FileManagerTest.h"
+
+#define   TEST_LEN          (FILE_MANAGER_COPY_BUFFER_SIZE * 3 + 100)
+#define   TEST_BLOCKS       4
+
+static TestFile                 src;
+static TestFile                 dst;
+static FileManager_Driver       driver;
+static const FileManager_Config smallConfig = { 512 };
+static int                      reads;
+static int                      writes;
+
+static FileManager_Result Test_read (FileManager* file, void* data, int32_t len) {
+    reads++;
+    return FileManager_posixRead(file, data, len);
+}
+
+static FileManager_Result Test_write (FileManager* file, void* data, int32_t len) {
+    writes++;
+    return FileManager_posixWrite(file, data, len);
+}
+
+int main (void) {
+    static uint8_t data[TEST_LEN];
+    static uint8_t got[TEST_LEN];
+    int            i;
+
+    for (i = 0; i < TEST_LEN; i++) {
+        data[i] = (uint8_t)(i * 29 + (i >> 8));
+    }
+    Test_open(&src, "fmtest_copy_src.bin", TEST_COMMANDS);
+    Test_open(&dst, "fmtest_copy_dst.bin", TEST_COMMANDS);
+    src.File.Config = &smallConfig;                                  ///// block is many sectors
+    dst.File.Config = &smallConfig;
+    driver       = posixFileManagerDriver;
+    driver.Read  = Test_read;
+    driver.Write = Test_write;
+    FileManager_Init(&driver);
+    TEST_CHECK(File_writeBlocking(&src.File, 0, data, TEST_LEN) == FileManager_OK);
+
+    reads  = 0;
+    writes = 0;
+    TEST_CHECK(File_copyBlocking(&src.File, &dst.File, 0, 0, TEST_LEN) == FileManager_OK);
+    TEST_CHECK(reads == TEST_BLOCKS && writes == TEST_BLOCKS);
+    TEST_CHECK(File_readBlocking(&dst.File, 0, got, TEST_LEN) == FileManager_OK && memcmp(got, data, TEST_LEN) == 0);
+
+    /* queued copy past end of src stop at end of src */
+    reads  = 0;
+    writes = 0;
+    TEST_CHECK(File_copy(&src.File, &dst.File, 0, TEST_LEN, TEST_LEN * 2) == FileManager_OK);
+    Test_drain(&dst);
+    TEST_CHECK(writes == TEST_BLOCKS && reads == TEST_BLOCKS + 2);   ///// rest of short last block and next pass find end of src
+    TEST_CHECK(File_getSize(&dst.File) == 2 * TEST_LEN);
+    TEST_CHECK(File_readBlocking(&dst.File, TEST_LEN, got, TEST_LEN) == FileManager_OK && memcmp(got, data, TEST_LEN) == 0);
+
+    Test_close(&src);
+    Test_close(&dst);
+    FileManager_Init(&posixFileManagerDriver);
+    return Test_result("copy");
+}
@@ -0,0 +1,60 @@
+/**
+ * @file FileManagerTestCoro.cpp
+ * @brief fm::AsyncFile resume each coroutine by Id of its command: write canceled by Dedupe get FileManager_DENIED,
+ *        write inside queued write get its own completion, read get its own Bytes
+ *
+ *        build: g++ -std=c++20 -I. -x c++ tests/FileManagerTestCoro.cpp -x c FileManager.c FileManagerLZ.c FileManagerCRC.c
+ *               FileManagerSwap.c FileManagerPortPosix.c Queue.c StreamBuffer.c -o test && ./test
+ */
+#include "FileManagerTest.h"
+#include "FileManagerCoro.hpp"
+
+static TestFile            test;
+static FileManager_Pending pending[8];
+static FileManager_Result  results[4];
+static fm::ReadResult      readResult;
+static uint8_t             readOut[32];
+static int                 finished;
+
+static fm::Task writer (fm::AsyncFile& file, int index, FileManager_Addr addr, std::span<const uint8_t> data) {
+    results[index] = co_await file.write(addr, data);
+    finished++;
+}
+
+static fm::Task reader (fm::AsyncFile& file, FileManager_Addr addr) {
+    readResult = co_await file.read(addr, readOut);
+    finished++;
+}
+
+int main (void) {
+    uint8_t old[16];
+    uint8_t replace[32];
+    uint8_t inner[4];
+    uint8_t data[32];
+
+    memset(old, 0x11, sizeof(old));
+    memset(replace, 0x22, sizeof(replace));
+    memset(inner, 0x33, sizeof(inner));
+    Test_open(&test, "fmtest_coro.bin", TEST_COMMANDS);
+    File_setPendingMap(&test.File, pending, 8);
+    File_setDedupe(&test.File, 1);
+    fm::AsyncFile file(&test.File);
+
+    TEST_CHECK(writer(file, 0, 0, old).started());
+    TEST_CHECK(writer(file, 1, 0, replace).started());               ///// cancel write 0 (it is in range of write 1)
+    TEST_CHECK(writer(file, 2, 4, inner).started());                 ///// own command (onComplete is set, no in place copy)
+    TEST_CHECK(finished == 0);
+    TEST_CHECK(reader(file, 0).started());
+    Test_drain(&test);
+
+    TEST_CHECK(finished == 4);
+    TEST_CHECK(results[0] == FileManager_DENIED);
+    TEST_CHECK(results[1] == FileManager_OK && results[2] == FileManager_OK);
+    TEST_CHECK(readResult.Result == FileManager_OK && readResult.Len == (int32_t)sizeof(readOut));
+    memcpy(data, replace, sizeof(data));
+    memcpy(data + 4, inner, sizeof(inner));
+    TEST_CHECK(memcmp(readOut, data, sizeof(data)) == 0);
+
+    Test_close(&test);
+    return Test_result("coro");
+}
@@ -0,0 +1,94 @@
+/**
+ * @file FileManagerTestDedupe.c
+ * @brief Dedupe: refused write (full CommandQueue or WriteStream) cancel nothing, covered write is canceled after new write is queued,
+ *        in place write only without onComplete (with it each write get its completion)
+ */
+#include "FileManagerTest.h"
+
+static TestFile            test;
+static FileManager_Pending pending[TEST_COMMANDS + 1];
+static int                 completed;
+static int                 denied;
+
+static void Test_onComplete (FileManager* file, FileManager_CommandHeader* command, FileManager_Result result) {
+    (void)file;
+    (void)command;
+    completed++;
+    denied += result == FileManager_DENIED;
+}
+
+static void Test_reopen (int commands) {
+    Test_open(&test, "fmtest_dedupe.bin", commands);
+    File_setPendingMap(&test.File, pending, TEST_COMMANDS + 1);
+    File_setDedupe(&test.File, 1);
+}
+
+int main (void) {
+    static uint8_t big[TEST_WRITE_STREAM];
+    uint8_t        data[32];
+    uint8_t        got[32];
+    uint32_t       lastId;
+    int            i;
+
+    /* full CommandQueue: new write is refused and older write stay */
+    Test_reopen(2);
+    memset(data, 0x11, sizeof(data));
+    TEST_CHECK(File_write(&test.File, 0, data, 16, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, 64, data, 16, FileManager_Var) == FileManager_OK);
+    memset(data, 0x22, sizeof(data));
+    TEST_CHECK(File_write(&test.File, 0, data, 32, FileManager_Var) == FileManager_NOT_ENOUGH_CORE);
+    TEST_CHECK(test.File.CancelCount == 0);
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 16) == FileManager_OK);
+    memset(data, 0x11, sizeof(data));
+    TEST_CHECK(memcmp(got, data, 16) == 0);
+    Test_close(&test);
+
+    /* full WriteStream: same */
+    Test_reopen(TEST_COMMANDS);
+    TEST_CHECK(File_write(&test.File, 0, data, 16, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, 100, big, TEST_WRITE_STREAM - 24, FileManager_Var) == FileManager_OK);
+    memset(data, 0x22, sizeof(data));
+    TEST_CHECK(File_write(&test.File, 0, data, 32, FileManager_Var) == FileManager_NOT_ENOUGH_CORE);
+    TEST_CHECK(test.File.CancelCount == 0);
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 16) == FileManager_OK);
+    memset(data, 0x11, sizeof(data));
+    TEST_CHECK(memcmp(got, data, 16) == 0);
+    Test_close(&test);
+
+    /* covered write is canceled, in place write without onComplete */
+    Test_reopen(TEST_COMMANDS);
+    TEST_CHECK(File_write(&test.File, 0, data, 16, FileManager_Var) == FileManager_OK);
+    memset(data, 0x22, sizeof(data));
+    TEST_CHECK(File_write(&test.File, 0, data, 32, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(test.File.CancelCount == 1);
+    lastId = File_getLastId(&test.File);
+    memset(data, 0x33, 8);
+    TEST_CHECK(File_write(&test.File, 8, data, 8, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_getLastId(&test.File) == lastId);               ///// copied into queued write
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 32) == FileManager_OK);
+    memset(data, 0x22, sizeof(data));
+    memset(data + 8, 0x33, 8);
+    TEST_CHECK(memcmp(got, data, 32) == 0);
+    Test_close(&test);
+
+    /* with onComplete each write get completion */
+    Test_reopen(TEST_COMMANDS);
+    File_onComplete(&test.File, Test_onComplete);
+    memset(data, 0x44, sizeof(data));
+    TEST_CHECK(File_write(&test.File, 0, data, 16, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, 0, data, 32, FileManager_Var) == FileManager_OK);
+    for (i = 0; i < 4; i++) {
+        lastId = File_getLastId(&test.File);
+        TEST_CHECK(File_write(&test.File, 4 * i, data, 4, FileManager_Var) == FileManager_OK);
+        TEST_CHECK(File_getLastId(&test.File) == lastId + 1);
+    }
+    Test_drain(&test);
+    TEST_CHECK(completed == 6);
+    TEST_CHECK(denied == 1);
+    Test_close(&test);
+
+    return Test_result("dedupe");
+}
@@ -0,0 +1,49 @@
+/**
+ * @file FileManagerTestDetect.c
+ * @brief Blocking functions clear Mounted of volume which is not detected, so it is Mounted again after card is back
+ */
+#include "FileManagerTest.h"
+
+static TestFile           test;
+static FileManager_Driver driver;
+static uint8_t            detected = 1;
+static int                mounts;
+
+static uint8_t Test_isDetected (FileManager_Volume* volume) {
+    return detected;
+}
+
+static FileManager_Result Test_mount (FileManager_Volume* volume, FileManager_MountMethod method) {
+    mounts++;
+    return posixFileManagerDriver.Mount(volume, method);
+}
+
+int main (void) {
+    uint8_t data[16];
+    uint8_t got[16];
+
+    memset(data, 0x3C, sizeof(data));
+    Test_open(&test, "fmtest_detect.bin", TEST_COMMANDS);
+    driver            = posixFileManagerDriver;
+    driver.IsDetected = Test_isDetected;
+    driver.Mount      = Test_mount;
+    FileManager_Init(&driver);
+    test.File.Volume->Mounted = 0;
+
+    TEST_CHECK(File_writeBlocking(&test.File, 0, data, sizeof(data)) == FileManager_OK);
+    TEST_CHECK(mounts == 1 && test.File.Volume->Mounted);
+
+    detected = 0;
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, sizeof(got)) == FileManager_DISK_ERR);
+    TEST_CHECK(!test.File.Volume->Mounted);
+    test.File.Volume->Mounted = 1;
+    TEST_CHECK(File_writeBlocking(&test.File, 0, data, sizeof(data)) != FileManager_OK);
+    TEST_CHECK(!test.File.Volume->Mounted);
+
+    detected = 1;
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, sizeof(got)) == FileManager_OK && memcmp(got, data, sizeof(data)) == 0);
+    TEST_CHECK(mounts == 2 && test.File.Volume->Mounted);           ///// card is Mounted again
+
+    Test_close(&test);
+    return Test_result("detect");
+}
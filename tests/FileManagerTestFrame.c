@@ -0,0 +1,79 @@
+/**
+ * @file FileManagerTestFrame.c
+ * @brief Framing: corrupt Frame give onError and FileManager_CRC_ERR without onRead, read which end in middle
+ *        of Frame is verified too
+ */
+#include "FileManagerTest.h"
+
+#define   FRAME_SIZE(len)      ((FileManager_Addr)(sizeof(FileManager_FrameHeader) + (len) + sizeof(uint32_t)))
+
+static TestFile           test;
+static uint8_t            data[300];
+static uint8_t            got[300];
+static int32_t            gotLen;
+static int                reads;
+static int                errors;
+static FileManager_Result lastResult;
+
+static void Test_onRead (FileManager* file, Stream* stream, FileManager_CommandHeader* command) {
+    gotLen = Stream_available(stream);
+    Stream_readBytes(stream, got, gotLen);
+    reads++;
+}
+
+static void Test_onError (FileManager* file, FileManager_Result result, FileManager_Addr addr) {
+    errors += result == FileManager_CRC_ERR && addr == FRAME_SIZE(100);
+}
+
+static void Test_onComplete (FileManager* file, FileManager_CommandHeader* command, FileManager_Result result) {
+    lastResult = result;
+}
+
+static void Test_read (FileManager_Addr addr, int32_t len) {
+    reads      = 0;
+    gotLen     = 0;
+    lastResult = FileManager_INT_ERR;
+    TEST_CHECK(File_read(&test.File, addr, len) == FileManager_OK);
+    Test_drain(&test);
+}
+
+int main (void) {
+    FILE*   raw;
+    int     i;
+
+    for (i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7);
+    }
+    Test_open(&test, "fmtest_frame.bin", TEST_COMMANDS);
+    File_setFraming(&test.File, 1);
+    File_onRead(&test.File, Test_onRead);
+    File_onError(&test.File, Test_onError);
+    File_onComplete(&test.File, Test_onComplete);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, 100, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data + 100, 200, FileManager_Var) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(File_getSize(&test.File) == (FileManager_Size)(FRAME_SIZE(100) + FRAME_SIZE(200)));
+
+    Test_read(0, 100);
+    TEST_CHECK(reads == 1 && gotLen == 100 && memcmp(got, data, 100) == 0 && lastResult == FileManager_OK);
+    Test_read(FRAME_SIZE(100), 50);                                 ///// end in middle of Frame, rest is read for CRC
+    TEST_CHECK(reads == 1 && gotLen == 50 && memcmp(got, data + 100, 50) == 0 && lastResult == FileManager_OK);
+
+    raw = fopen("fmtest_frame.bin", "r+b");                         ///// flip one Byte after read range of second Frame
+    TEST_CHECK(raw != NULL);
+    fseek(raw, FRAME_SIZE(100) + sizeof(FileManager_FrameHeader) + 150, SEEK_SET);
+    fputc(data[250] ^ 0x01, raw);
+    fclose(raw);
+
+    Test_read(FRAME_SIZE(100), 50);
+    TEST_CHECK(reads == 0 && errors == 1 && lastResult == FileManager_CRC_ERR);
+    Test_read(FRAME_SIZE(100), 200);
+    TEST_CHECK(reads == 0 && errors == 2 && lastResult == FileManager_CRC_ERR);
+    TEST_CHECK(Stream_available(&test.File.ReadStream) == 0);       ///// corrupt Data is dropped
+
+    Test_read(0, 100);                                              ///// next read is not mixed with dropped Data
+    TEST_CHECK(reads == 1 && gotLen == 100 && memcmp(got, data, 100) == 0 && lastResult == FileManager_OK);
+
+    Test_close(&test);
+    return Test_result("frame");
+}
@@ -0,0 +1,73 @@
+/**
+ * @file FileManagerTestKV.c
+ * @brief Key-Value Store: get of queued Record through pending map and Compaction run as queued commands
+ *
+ *        build: add FileManagerKV.c to build line of FileManagerTest.h
+ */
+#include "FileManagerTest.h"
+#include "FileManagerKV.h"
+
+static TestFile            test[2];
+static FileManager_Pending pending[2][16];
+static FileManagerKV_Entry entries[16];
+static uint8_t             buffer[512];
+static FileManagerKV       kv;
+
+static void Test_openKV (void) {
+    FileManagerKV_init(&kv, &test[0].File, &test[1].File, entries, 16, buffer, sizeof(buffer), 64);
+}
+
+int main (void) {
+    uint32_t value;
+    uint32_t generation;
+    int      i;
+
+    Test_open(&test[0], "fmtest_kv0.bin", TEST_COMMANDS);
+    Test_open(&test[1], "fmtest_kv1.bin", TEST_COMMANDS);
+    File_setPendingMap(&test[0].File, pending[0], 16);
+    File_setPendingMap(&test[1].File, pending[1], 16);
+    Test_openKV();
+    TEST_CHECK(FileManagerKV_mount(&kv) == FileManager_OK);
+
+    value = 1234;
+    TEST_CHECK(FileManagerKV_put(&kv, 1, &value, sizeof(value)) == FileManager_OK);
+    value = 0;
+    TEST_CHECK(FileManagerKV_get(&kv, 1, &value, sizeof(value)) == FileManager_OK);   ///// Record is in WriteStream yet
+    TEST_CHECK(value == 1234);
+
+    File_setPendingMap(&test[0].File, NULL, 0);
+    value = 99;
+    TEST_CHECK(FileManagerKV_put(&kv, 2, &value, sizeof(value)) == FileManager_OK);
+    TEST_CHECK(FileManagerKV_get(&kv, 2, &value, sizeof(value)) == FileManager_LOCKED);
+    Test_drain(&test[0]);
+    TEST_CHECK(FileManagerKV_get(&kv, 2, &value, sizeof(value)) == FileManager_OK);
+    TEST_CHECK(value == 99);
+    File_setPendingMap(&test[0].File, pending[0], 16);
+
+    generation = kv.Generation;
+    for (i = 0; i < 40; i++) {                                      ///// overwrite same Keys, garbage start Compaction
+        value = (uint32_t)i;
+        TEST_CHECK(FileManagerKV_put(&kv, (uint16_t)(1 + i % 2), &value, sizeof(value)) == FileManager_OK);
+        Test_drain(&test[0]);
+    }
+    for (i = 0; i < 100 && kv.Compacting; i++) {
+        FileManager_handle();
+    }
+    TEST_CHECK(kv.Generation > generation && !kv.Compacting);       ///// Compaction done only from onIdle of FileManager_handle
+    generation = kv.Generation;
+    TEST_CHECK(FileManagerKV_get(&kv, 1, &value, sizeof(value)) == FileManager_OK && value == 38);
+    TEST_CHECK(FileManagerKV_get(&kv, 2, &value, sizeof(value)) == FileManager_OK && value == 39);
+    Test_drain(&test[kv.Active]);
+    TEST_CHECK(File_getSize(&test[kv.Active].File) == (uint32_t)kv.End);
+
+    i = kv.Active;
+    Test_openKV();                                                  ///// mount again select compacted File
+    TEST_CHECK(FileManagerKV_mount(&kv) == FileManager_OK);
+    TEST_CHECK(kv.Active == i && kv.Generation == generation);
+    TEST_CHECK(FileManagerKV_get(&kv, 1, &value, sizeof(value)) == FileManager_OK && value == 38);
+    TEST_CHECK(FileManagerKV_get(&kv, 2, &value, sizeof(value)) == FileManager_OK && value == 39);
+
+    Test_close(&test[0]);
+    Test_close(&test[1]);
+    return Test_result("kv");
+}
@@ -0,0 +1,87 @@
+/**
+ * @file FileManagerTestLZ.c
+ * @brief Compression: read, mapped read and Logger read decode Blocks, raw Fill/Copy/Truncate and writes at an Address are refused on compressed File
+ */
+#include "FileManagerTest.h"
+
+static TestFile               test;
+static TestFile               other;
+static FileManager_Compress   compress[2];
+static uint8_t                block[2][256];
+static uint8_t                coded[2][256 + sizeof(FileManager_BlockHeader)];
+static FileManager_BlockIndex blocks[2][8];
+static uint8_t                data[1200];
+static uint8_t                got[1200];
+static int32_t                gotLen;
+
+static void Test_onRead (FileManager* file, Stream* stream, FileManager_CommandHeader* command) {
+    gotLen = Stream_available(stream);
+    Stream_readBytes(stream, got, gotLen);
+}
+
+int main (void) {
+    FileManager_RecFrame frame = { "lz", 7 };
+    DateTime_X           dt;
+    char                 path[MAX_PATH_LENGTH];
+    Stream               lock;
+    uint16_t             values[4] = { 1, 2, 3, 4 };
+    int                  i;
+
+    for (i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (uint8_t)"time,temp,rh;0012,23.5,41;"[i % 26];
+    }
+    memset(&dt, 0, sizeof(dt));
+    dt.Year  = 23;
+    dt.Month = 1;
+    dt.Day   = 23;
+    snprintf(path, sizeof(path), FILE_MANAGER_PATH_FORMAT, frame.DeviceId, frame.Indicator, dt.Year, dt.Month, dt.Day, dt.Hour, dt.Minute);
+
+    Test_open(&test, "fmtest_lz.bin", TEST_COMMANDS);
+    Test_open(&other, path, TEST_COMMANDS);
+    TEST_CHECK(File_setCompression(&test.File, &compress[0], block[0], 256, coded[0], sizeof(coded[0]), blocks[0], 8) == FileManager_OK);
+    TEST_CHECK(File_setCompression(&other.File, &compress[1], block[1], 256, coded[1], sizeof(coded[1]), blocks[1], 8) == FileManager_OK);
+    File_onRead(&test.File, Test_onRead);
+
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, sizeof(data), FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_fill(&test.File, END_OF_FILE, 100, 0xFF) == FileManager_NOT_ENABLED);
+    TEST_CHECK(File_copy(&other.File, &test.File, 0, END_OF_FILE, 100) == FileManager_NOT_ENABLED);
+    TEST_CHECK(File_queueTruncate(&test.File, 0) == FileManager_NOT_ENABLED);
+    TEST_CHECK(File_write(&test.File, 10, data, 10, FileManager_Var) == FileManager_NOT_ENABLED);
+    TEST_CHECK(File_writeArrayU16(&test.File, 10, values, 4, FileManager_NativeEndian) == FileManager_NOT_ENABLED);
+    TEST_CHECK(File_writeArrayU16(&test.File, 10, values, 4, FileManager_BigEndian) == FileManager_NOT_ENABLED);
+    TEST_CHECK(File_beginWrite(&test.File, &lock, 10) == &lock);
+    Stream_writeBytes(&lock, data, 10);
+    TEST_CHECK(File_endWrite(&test.File, 10, &lock) == FileManager_NOT_ENABLED);
+    TEST_CHECK(Queue_available(&test.File.CommandQueue) == 1 && Stream_available(&test.File.WriteStream) == (int32_t)sizeof(data));
+    Test_drain(&test);
+    TEST_CHECK(File_getSize(&test.File) < sizeof(data) / 2);       ///// last Block is in RAM yet
+
+    TEST_CHECK(File_read(&test.File, 300, 500) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(gotLen == 500);                                       ///// read cross Blocks, each Block is decoded
+    TEST_CHECK(memcmp(got, data + 300, gotLen) == 0);
+    gotLen = 0;
+    TEST_CHECK(File_readMapped(&test.File, 300, 500) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(gotLen == 500 && memcmp(got, data + 300, gotLen) == 0);   ///// not raw Blocks of mapped File
+
+    TEST_CHECK(File_write(&other.File, END_OF_FILE, data, sizeof(data), FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_flush(&other.File) == FileManager_OK);
+    Test_drain(&other);
+
+    test.File.Args1 = &frame;                                       ///// Logger Argument give other Path
+    gotLen = 0;
+    TEST_CHECK(File_loggerRead(&test.File, &dt, 1100, 100) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(gotLen == 100);
+    TEST_CHECK(memcmp(got, data + 1100, 100) == 0);                  ///// decoded Bytes of other Path
+
+    gotLen = 0;
+    TEST_CHECK(File_read(&test.File, 1030, 100) == FileManager_OK);  ///// own File again, last Block was written before Logger read
+    Test_drain(&test);
+    TEST_CHECK(gotLen == 100 && memcmp(got, data + 1030, 100) == 0);
+
+    Test_close(&other);
+    Test_close(&test);
+    return Test_result("lz");
+}
@@ -0,0 +1,47 @@
+/**
+ * @file FileManagerTestList.c
+ * @brief File list: FileManager_remove take File out of ready-list at any place, drop its queued commands and
+ *        clear marker of other Files, FileManager_add and FileManager_find refuse NULL Path
+ */
+#include "FileManagerTest.h"
+
+static TestFile             test[3];
+static FileManager          bad;
+static FileManager_PosixFil badFil = FILE_MANAGER_POSIX_FIL_INIT;
+
+int main (void) {
+    static const char* paths[3] = { "fmtest_list0.bin", "fmtest_list1.bin", "fmtest_list2.bin" };
+    uint8_t            data[32];
+    int                i;
+
+    memset(data, 0x42, sizeof(data));
+    for (i = 0; i < 3; i++) {
+        Test_open(&test[i], paths[i], TEST_COMMANDS);
+        TEST_CHECK(File_write(&test[i].File, END_OF_FILE, data, sizeof(data), FileManager_Var) == FileManager_OK);
+    }
+    TEST_CHECK(FileManager_find((const uint8_t*)paths[1]) == &test[1].File);
+    File_setCheckpoint(&test[0].File, &test[1].File, 4096);
+    TEST_CHECK(FileManager_remove(&test[1].File) == FileManager_OK);   ///// middle of ready-list
+    TEST_CHECK(FileManager_find((const uint8_t*)paths[1]) == FILE_MANAGER_NULL);
+    TEST_CHECK(Queue_available(&test[1].File.CommandQueue) == 0 && Stream_available(&test[1].File.WriteStream) == 0);
+    TEST_CHECK(test[1].File.CommandHeaderInProcess.Len == 0);
+    TEST_CHECK(test[0].File.Marker == FILE_MANAGER_NULL);
+    TEST_CHECK(FileManager_remove(&test[2].File) == FileManager_OK);   ///// tail of ready-list
+    Test_drain(&test[0]);
+    TEST_CHECK(File_getSize(&test[0].File) == sizeof(data));
+
+    Test_open(&test[2], paths[2], TEST_COMMANDS);                     ///// new tail after removed tail
+    TEST_CHECK(File_write(&test[2].File, END_OF_FILE, data, sizeof(data), FileManager_Var) == FileManager_OK);
+    Test_drain(&test[2]);
+    TEST_CHECK(File_getSize(&test[2].File) == sizeof(data));
+
+    TEST_CHECK(FileManager_add(&bad, &badFil, &posixFileConfig, NULL) == FileManager_INVALID_PARAMETER);
+    TEST_CHECK(FileManager_add(&bad, &badFil, NULL, (uint8_t*)"fmtest_bad.bin") == FileManager_INVALID_PARAMETER);
+    TEST_CHECK(FileManager_setNewPath(&test[0].File, NULL) == FileManager_INVALID_PARAMETER);
+    TEST_CHECK(FileManager_find(NULL) == FILE_MANAGER_NULL);
+
+    Test_close(&test[0]);
+    Test_close(&test[2]);
+    unlink(paths[1]);
+    return Test_result("list");
+}
@@ -0,0 +1,81 @@
+/**
+ * @file FileManagerTestPending.c
+ * @brief pending map: queued Fill/Const/Copy/Truncate are barriers, File_readBlocking of Bytes which they change (or Bytes after
+ *        end of File) return FileManager_LOCKED until they are done, other Bytes still come from pending writes and card,
+ *        Logger write (File_beginWrite/File_endWrite) is refused when pending map is full
+ */
+#include "FileManagerTest.h"
+
+static TestFile            test;
+static FileManager_Pending pending[8];
+static uint8_t             constData[8];
+
+static int Test_all (const uint8_t* data, int len, uint8_t value) {
+    int i;
+    for (i = 0; i < len; i++) {
+        if (data[i] != value) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main (void) {
+    uint8_t data[64];
+    uint8_t got[64];
+    Stream  lock;
+
+    memset(data, 0x11, sizeof(data));
+    memset(constData, 0x44, sizeof(constData));
+    Test_open(&test, "fmtest_pending.bin", TEST_COMMANDS);
+    TEST_CHECK(File_writeBlocking(&test.File, 0, data, sizeof(data)) == FileManager_OK);
+    File_setPendingMap(&test.File, pending, 8);
+
+    memset(data, 0x22, 16);
+    TEST_CHECK(File_write(&test.File, 0, data, 16, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_fill(&test.File, 8, 16, 0x33) == FileManager_OK);
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 32) == FileManager_LOCKED);
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 8) == FileManager_OK);       ///// before Fill, pending write
+    TEST_CHECK(Test_all(got, 8, 0x22));
+    TEST_CHECK(File_readBlocking(&test.File, 40, got, 8) == FileManager_OK);      ///// after Fill, card
+    TEST_CHECK(Test_all(got, 8, 0x11));
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 32) == FileManager_OK);
+    TEST_CHECK(Test_all(got, 8, 0x22) && Test_all(got + 8, 16, 0x33) && Test_all(got + 24, 8, 0x11));
+
+    TEST_CHECK(File_write(&test.File, 32, constData, sizeof(constData), FileManager_Const) == FileManager_OK);
+    TEST_CHECK(File_readBlocking(&test.File, 36, got, 8) == FileManager_LOCKED);
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 32, got, 8) == FileManager_OK);
+    TEST_CHECK(Test_all(got, 8, 0x44));
+
+    TEST_CHECK(File_queueTruncate(&test.File, 48) == FileManager_OK);
+    TEST_CHECK(File_readBlocking(&test.File, 50, got, 4) == FileManager_LOCKED);
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 50, got, 4) == FileManager_EOF);
+
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, constData, sizeof(constData), FileManager_Const) == FileManager_OK);
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, 8, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_readBlocking(&test.File, 48, got, 16) == FileManager_LOCKED);   ///// place of Var append depend on Const append
+    TEST_CHECK(File_readBlocking(&test.File, 0, got, 8) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 48, got, 16) == FileManager_OK);
+    TEST_CHECK(Test_all(got, 8, 0x44) && Test_all(got + 8, 8, 0x22));
+
+    File_setPendingMap(&test.File, pending, 2);
+    TEST_CHECK(File_write(&test.File, 0, data, 8, FileManager_Var) == FileManager_OK);
+    TEST_CHECK(File_beginWrite(&test.File, &lock, 8) == &lock);
+    memset(data, 0x55, 8);
+    Stream_writeBytes(&lock, data, 8);
+    TEST_CHECK(File_endWrite(&test.File, 16, &lock) == FileManager_OK);
+    TEST_CHECK(File_readBlocking(&test.File, 16, got, 8) == FileManager_OK);        ///// Logger write is in pending map
+    TEST_CHECK(Test_all(got, 8, 0x55));
+    TEST_CHECK(File_beginWrite(&test.File, &lock, 8) == NULL);                      ///// map is full, nothing is locked
+    TEST_CHECK(Stream_available(&test.File.WriteStream) == 16);
+    Test_drain(&test);
+    TEST_CHECK(File_readBlocking(&test.File, 16, got, 8) == FileManager_OK);
+    TEST_CHECK(Test_all(got, 8, 0x55));
+
+    Test_close(&test);
+    return Test_result("pending");
+}
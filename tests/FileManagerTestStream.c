@@ -0,0 +1,63 @@
+/**
+ * @file FileManagerTestStream.c
+ * @brief File_readStream: chunks cover File up to its end, File which end at chunk boundary give no empty chunk,
+ *        onComplete end command
+ */
+#include "FileManagerTest.h"
+
+static TestFile test;
+static uint8_t  got[FILE_MANAGER_POSIX_SECTOR * 4];
+static int32_t  gotLen;
+static int32_t  lastRemain;
+static int      chunks;
+static int      empty;
+static int      completes;
+
+static void Test_onReadChunk (FileManager* file, Stream* stream, FileManager_Addr addr, int32_t len, int32_t remain) {
+    chunks++;
+    empty     += len == 0;
+    lastRemain = remain;
+    Stream_readBytes(stream, got + gotLen, len);
+    gotLen    += len;
+}
+
+static void Test_onComplete (FileManager* file, FileManager_CommandHeader* command, FileManager_Result result) {
+    completes++;
+}
+
+static void Test_readStream (FileManager_Addr addr, int32_t len) {
+    memset(got, 0, sizeof(got));
+    gotLen     = 0;
+    lastRemain = -1;
+    chunks     = 0;
+    empty      = 0;
+    completes  = 0;
+    TEST_CHECK(File_readStream(&test.File, addr, len) == FileManager_OK);
+    Test_drain(&test);
+}
+
+int main (void) {
+    static uint8_t data[FILE_MANAGER_POSIX_SECTOR * 2];
+    int            i;
+
+    for (i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7 + 1);
+    }
+    Test_open(&test, "fmtest_stream.bin", TEST_COMMANDS);
+    File_onReadChunk(&test.File, Test_onReadChunk);
+    File_onComplete(&test.File, Test_onComplete);
+
+    /* File end at chunk boundary: no empty chunk, onComplete end command */
+    TEST_CHECK(File_writeBlocking(&test.File, 0, data, sizeof(data)) == FileManager_OK);
+    Test_readStream(0, sizeof(data) * 2);
+    TEST_CHECK(gotLen == sizeof(data) && memcmp(got, data, sizeof(data)) == 0);
+    TEST_CHECK(empty == 0 && chunks == 2 && completes == 1);
+
+    /* File end in middle of chunk: last chunk is short and has no remaining Bytes */
+    Test_readStream(sizeof(data) - 100, 300);
+    TEST_CHECK(gotLen == 100 && memcmp(got, data + sizeof(data) - 100, 100) == 0);
+    TEST_CHECK(chunks == 1 && lastRemain == 0 && completes == 1);
+
+    Test_close(&test);
+    return Test_result("stream");
+}
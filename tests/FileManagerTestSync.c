@@ -0,0 +1,34 @@
+/**
+ * @file FileManagerTestSync.c
+ * @brief SyncPolicy: File_flush on full CommandQueue is refused (not dropped) and queued flush make Data durable
+ */
+#include "FileManagerTest.h"
+
+static TestFile test;
+
+int main (void) {
+    uint8_t  data[64];
+    uint32_t syncs;
+    int      i;
+
+    memset(data, 0x5A, sizeof(data));
+    Test_open(&test, "fmtest_sync.bin", 8);
+    File_setSyncPolicy(&test.File, FileManager_SyncExplicit, 0);
+
+    for (i = 0; i < 8; i++) {
+        TEST_CHECK(File_write(&test.File, END_OF_FILE, data, sizeof(data), FileManager_Var) == FileManager_OK);
+    }
+    TEST_CHECK(File_write(&test.File, END_OF_FILE, data, sizeof(data), FileManager_Var) == FileManager_NOT_ENOUGH_CORE);
+    TEST_CHECK(File_flush(&test.File) == FileManager_NOT_ENOUGH_CORE);
+    Test_drain(&test);
+    TEST_CHECK(File_getStats(&test.File)->SyncCount == 0);          ///// SyncExplicit keep Data dirty
+
+    syncs = File_getStats(&test.File)->SyncCount;
+    TEST_CHECK(File_flush(&test.File) == FileManager_OK);
+    Test_drain(&test);
+    TEST_CHECK(File_getStats(&test.File)->SyncCount == syncs + 1);
+    TEST_CHECK(File_getSize(&test.File) == 8 * sizeof(data));
+
+    Test_close(&test);
+    return Test_result("sync");
+}
@@ -0,0 +1,190 @@
+/**
+ * @file FileManagerBench.c
+ * @author Reza Dehghan
+ * @brief Host benchmark of Data path stages, same log records are written through FileManager_handle with and
+ *        without the stage and on-card Bytes and end to end throughput are reported,
+ *        crc stage also report CRC32C MB/s of FileManagerCRC_update alone to compare with card MB/s
+ *
+ *        build: gcc -O2 -I. tools/FileManagerBench.c FileManager.c FileManagerLZ.c FileManagerCRC.c FileManagerSwap.c
+ *               FileManagerPortPosix.c Queue.c StreamBuffer.c -o fmbench
+ *        run:   ./fmbench lz 16 4
+ *               ./fmbench crc 16 25
+ *
+ *        args:  stage (lz|crc)  MB of log records  MB/s of card, card time is modelled as on-card Bytes / card MB/s
+ *               and added to host time, so end to end MB/s show gain of fewer Bytes on slow card
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "FileManagerPortPosix.h"
+#include "FileManagerCRC.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_PATH         "fmbench.bin"
+#define BENCH_CHUNK        2048                              ///// Bytes of records in one File_write
+#define BENCH_BLOCK        4096                              ///// raw Block of Compression
+
+typedef struct {
+    const char*      Name;
+    uint64_t         Logical;        ///// Bytes given to File_write
+    uint64_t         Physical;       ///// Bytes on card
+    double           Seconds;        ///// host time
+} Bench_Result;
+
+static FileManager               file;
+static FileManager_PosixFil      fil = FILE_MANAGER_POSIX_FIL_INIT;
+static FileManager_CommandHeader commandQ[64];
+static FileManager_CommandHeader readQ[4];
+static uint8_t                   writeStream[32768];
+static uint8_t                   readStream[4096];
+static FileManager_Compress      compress;
+static uint8_t                   block[BENCH_BLOCK];
+static uint8_t                   coded[BENCH_BLOCK + sizeof(FileManager_BlockHeader)];
+static FileManager_BlockIndex    blockIndex[256];
+static uint8_t                   chunk[BENCH_CHUNK + 128];
+static uint8_t                   records[1 << 20];      ///// input of crc stage
+
+
+
+static double Bench_now (void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief fill chunk with text log records (same seed give same records in each run)
+ */
+static int32_t Bench_records (uint32_t* seed, uint32_t* second) {
+    int32_t len = 0;
+    while (len < BENCH_CHUNK) {
+        *seed  = *seed * 1103515245u + 12345u;
+        len   += snprintf((char*)chunk + len, sizeof(chunk) - len, "2023-01-23 %02u:%02u:%02u,dev=%u,temp=%u.%u,rh=%u,state=%s\n",
+                          (*second / 3600) % 24, (*second / 60) % 60, *second % 60, (*seed >> 8) % 4, 20 + (*seed >> 12) % 5,
+                          (*seed >> 16) % 10, 40 + (*seed >> 20) % 20, (*seed >> 24) % 8 ? "ok" : "warn");
+        (*second)++;
+    }
+    return len;
+}
+
+/**
+ * @brief write bytes of records into new File, optional stage (Compression or Framing) is enabled before first write
+ */
+static Bench_Result Bench_run (const char* name, uint64_t bytes, uint8_t lz, uint8_t framing) {
+    Bench_Result result;
+    struct stat  st;
+    uint32_t     seed   = 1;
+    uint32_t     second = 0;
+    int32_t      len;
+    double       start;
+
+    unlink(BENCH_PATH);
+    fil = (FileManager_PosixFil)FILE_MANAGER_POSIX_FIL_INIT;
+    FileManager_add(&file, &fil, &posixFileConfig, (uint8_t*)BENCH_PATH);
+    File_init(&file, (uint8_t*)commandQ, sizeof(commandQ), (uint8_t*)readQ, sizeof(readQ), writeStream, sizeof(writeStream), readStream, sizeof(readStream));
+    File_setSyncPolicy(&file, FileManager_SyncExplicit, 0);
+    if (lz) {
+        File_setCompression(&file, &compress, block, sizeof(block), coded, sizeof(coded), blockIndex, 256);
+    }
+    File_setFraming(&file, framing);
+    result.Name    = name;
+    result.Logical = 0;
+    start          = Bench_now();
+    while (result.Logical < bytes) {
+        len = Bench_records(&seed, &second);
+        while (File_write(&file, END_OF_FILE, chunk, len, FileManager_Var) != FileManager_OK) {
+            FileManager_handle();
+        }
+        result.Logical += len;
+        FileManager_handle();
+    }
+    while (File_flush(&file) != FileManager_OK) {
+        FileManager_handle();
+    }
+    while (Queue_available(&file.CommandQueue) > 0 || file.CommandHeaderInProcess.Len > 0) {
+        FileManager_handle();
+    }
+    FileManager_handle();
+    result.Seconds  = Bench_now() - start;
+    File_setFraming(&file, 0);
+    FileManager_remove(&file);
+    result.Physical = stat(BENCH_PATH, &st) == 0 ? (uint64_t)st.st_size : 0;
+    unlink(BENCH_PATH);
+    return result;
+}
+
+/**
+ * @brief CRC32C of records only, no I/O
+ */
+static Bench_Result Bench_crc (uint64_t bytes) {
+    Bench_Result result;
+    uint32_t     seed   = 1;
+    uint32_t     second = 0;
+    uint32_t     crc    = FILE_MANAGER_CRC_INIT;
+    int32_t      len    = 0;
+    double       start;
+
+    while (len + BENCH_CHUNK + 128 <= (int32_t)sizeof(records)) {
+        Bench_records(&seed, &second);
+        memcpy(records + len, chunk, BENCH_CHUNK);
+        len += BENCH_CHUNK;
+    }
+    result.Name     = "crc32c";
+    result.Logical  = 0;
+    result.Physical = 0;
+    start           = Bench_now();
+    while (result.Logical < bytes) {
+        crc             = FileManagerCRC_update(crc, records, len);
+        result.Logical += len;
+    }
+    result.Seconds = Bench_now() - start;
+    printf("crc32c %08x  %8.1f MB/s\n", (unsigned)FileManagerCRC_final(crc), (double)result.Logical / 1e6 / result.Seconds);
+    return result;
+}
+
+static void Bench_print (const Bench_Result* result, double cardMBs) {
+    double card = (double)result->Physical / (cardMBs * 1e6);
+    printf("%-6s logical %10llu  on-card %10llu  ratio %5.2f  host %8.1f MB/s  end-to-end %7.2f MB/s\n", result->Name,
+           (unsigned long long)result->Logical, (unsigned long long)result->Physical,
+           result->Physical > 0 ? (double)result->Logical / (double)result->Physical : 0.0,
+           (double)result->Logical / 1e6 / result->Seconds, (double)result->Logical / 1e6 / (result->Seconds + card));
+}
+
+
+
+int main (int argc, char** argv) {
+    const char*  stage   = argc > 1 ? argv[1] : "lz";
+    uint64_t     bytes   = (uint64_t)(argc > 2 ? atoi(argv[2]) : 16) << 20;
+    double       cardMBs = argc > 3 ? atof(argv[3]) : 4.0;
+    Bench_Result raw;
+    Bench_Result result;
+
+    if (cardMBs <= 0) {
+        cardMBs = 4.0;
+    }
+    FileManager_Init(&posixFileManagerDriver);
+    if (strcmp(stage, "lz") == 0) {
+        raw    = Bench_run("raw", bytes, 0, 0);
+        result = Bench_run("lz", bytes, 1, 0);
+    }
+    else if (strcmp(stage, "crc") == 0) {
+        Bench_crc(bytes * 4);
+        raw    = Bench_run("raw", bytes, 0, 0);
+        result = Bench_run("framed", bytes, 0, 1);
+    }
+    else {
+        printf("stage: lz|crc\n");
+        return 1;
+    }
+    printf("card %.1f MB/s\n", cardMBs);
+    Bench_print(&raw, cardMBs);
+    Bench_print(&result, cardMBs);
+    return 0;
+}
@@ -0,0 +1,523 @@
+/**
+ * @file FileManagerReplay.c
+ * @author Reza Dehghan
+ * @brief Host replay of FileManagerTrace File, each configuration (Buffer sizes, MaxSS, handle period, SyncPolicy, driver)
+ *        run whole trace through FileManager_handle and report throughput, command latency and overflow
+ *
+ *        build: gcc -O2 -I. tools/FileManagerReplay.c FileManager.c FileManagerLZ.c FileManagerCRC.c FileManagerSwap.c
+ *               FileManagerTrace.c FileManagerPortPosix.c Queue.c StreamBuffer.c -o fmreplay
+ *        run:   ./fmreplay trace.bin "q=16,ws=4096" "q=64,ws=16384,period=10,policy=time,thr=100" "drv=posix,q=64"
+ *
+ *        keys:  drv=sim|posix  q=CommandQueue depth  ws/rs=WriteStream/ReadStream Bytes  ss=MaxSS
+ *               period=ms between FileManager_handle calls  passes=FileManager_handle calls in each period
+ *               policy=close|bytes|time|cmd|explicit  thr=SyncThreshold
+ *               lat=us of each sim driver call  bw=MB/s of sim driver  sync=us of sim Sync/Close
+ *               run=Bytes and hold=ms of File_setAlignment  au=Bytes of sim allocation unit  gc=us of sim write which cross au
+ * @version 0.1
+ * @date 2023-01-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "FileManagerTrace.h"
+#include "FileManagerPortPosix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define REPLAY_STALL_US    60000000u                         ///// stop run when no command is complete for 60 s after end of trace
+
+typedef struct {
+    uint8_t          Posix;
+    uint16_t         QueueDepth;
+    uint16_t         WriteBytes;
+    uint16_t         ReadBytes;
+    uint16_t         MaxSS;
+    uint32_t         Period;         ///// us
+    uint16_t         Passes;
+    uint8_t          Policy;
+    uint32_t         Threshold;
+    uint32_t         Latency;        ///// us
+    uint32_t         Bandwidth;      ///// Bytes/us (= MB/s)
+    uint32_t         SyncLatency;    ///// us
+    uint32_t         Run;            ///// Bytes, 0 -> no alignment
+    uint32_t         MaxHold;        ///// ms
+    uint32_t         AllocUnit;      ///// Bytes, 0 -> no gc cost
+    uint32_t         GcLatency;      ///// us
+} Replay_Config;
+
+typedef struct {
+    FileManager_Addr Pos;
+    FileManager_Size Size;
+    uint8_t          Open;
+} Replay_SimFil;
+
+typedef struct {
+    FileManager          File;
+    FileManager_PosixFil Posix;
+    Replay_SimFil        Sim;
+    uint8_t*             Buffers;
+    uint64_t*            Queued;     ///// queue time of commands in flight (onComplete come in order)
+    int32_t*             Lens;
+    uint16_t             Head;
+    uint16_t             Count;
+    uint16_t             Depth;
+    char                 Path[32];
+} Replay_File;
+
+static uint64_t                 nowUs;
+static Replay_Config            config;
+static Replay_File              files[FILE_MANAGER_TRACE_FILES];
+static uint8_t                  fileCount;
+static FileManager_Config       fileConfig;
+static FileManager_Driver       driver;
+static uint32_t*                latencies;
+static uint32_t                 latencyCount;
+static uint64_t                 doneBytes;
+static uint64_t                 lastDoneUs;
+static uint8_t*                 payload;
+static uint8_t                  scratch[65536];
+
+
+
+static uint32_t Replay_getTimestamp (void) {
+    return (uint32_t)(nowUs / 1000);
+}
+
+static void Replay_cost (int32_t len) {
+    nowUs += config.Latency + (len > 0 ? (uint32_t)len / config.Bandwidth : 0);
+}
+
+#define REPLAY_SIM(file)   ((Replay_SimFil*)(file)->Context)
+
+static FileManager_Result Replay_simOpen (FileManager* file, uint8_t* path, FileManager_OpenMethod openMethod) {
+    (void)path;
+    (void)openMethod;
+    Replay_cost(0);
+    REPLAY_SIM(file)->Open = 1;
+    REPLAY_SIM(file)->Pos  = 0;
+    return FileManager_OK;
+}
+
+static FileManager_Result Replay_simWrite (FileManager* file, void* data, int32_t len) {
+    Replay_SimFil* sim = REPLAY_SIM(file);
+    (void)data;
+    Replay_cost(len);
+    if (config.AllocUnit > 0 && (uint64_t)sim->Pos / config.AllocUnit != (uint64_t)(sim->Pos + len - 1) / config.AllocUnit) {
+        nowUs += config.GcLatency;                          ///// write cross allocation unit of card
+    }
+    sim->Pos         += len;
+    sim->Size         = (FileManager_Size)sim->Pos > sim->Size ? (FileManager_Size)sim->Pos : sim->Size;
+    file->PendingByte = len;
+    return FileManager_OK;
+}
+
+static FileManager_Result Replay_simRead (FileManager* file, void* data, int32_t len) {
+    Replay_cost(len);
+    memset(data, 0, len);
+    REPLAY_SIM(file)->Pos += len;
+    file->PendingByte      = len;
+    return FileManager_OK;
+}
+
+static FileManager_Result Replay_simMount (FileManager_Volume* volume, FileManager_MountMethod mountMethod) {
+    (void)volume;
+    (void)mountMethod;
+    return FileManager_OK;
+}
+
+static FileManager_Result Replay_simUnMount (FileManager_Volume* volume) {
+    (void)volume;
+    return FileManager_OK;
+}
+
+static FileManager_Result Replay_simLseek (FileManager* file, FileManager_Addr addr) {
+    REPLAY_SIM(file)->Pos = addr;
+    return FileManager_OK;
+}
+
+static FileManager_Result Replay_simClose (FileManager* file) {
+    nowUs += config.SyncLatency;
+    REPLAY_SIM(file)->Open = 0;
+    return FileManager_OK;
+}
+
+static uint8_t Replay_simIsOpen (FileManager* file) {
+    return REPLAY_SIM(file)->Open;
+}
+
+static FileManager_Size Replay_simGetSize (FileManager* file) {
+    return REPLAY_SIM(file)->Size;
+}
+
+static uint8_t Replay_simIsDetected (FileManager_Volume* volume) {
+    (void)volume;
+    return 1;
+}
+
+static FileManager_Result Replay_simUnLink (uint8_t* path) {
+    (void)path;
+    return FileManager_OK;
+}
+
+static FileManager_Result Replay_simTruncate (FileManager* file) {
+    REPLAY_SIM(file)->Size = REPLAY_SIM(file)->Pos;
+    return FileManager_OK;
+}
+
+static FileManager_Result Replay_simSync (FileManager* file) {
+    (void)file;
+    nowUs += config.SyncLatency;
+    return FileManager_OK;
+}
+
+static const FileManager_Driver simDriver = {
+    Replay_simOpen,
+    Replay_simWrite,
+    Replay_simRead,
+    Replay_simMount,
+    Replay_simUnMount,
+    Replay_simLseek,
+    Replay_simClose,
+    Replay_simIsOpen,
+    Replay_simGetSize,
+    Replay_simIsDetected,
+    Replay_simUnLink,
+    Replay_getTimestamp,
+    Replay_simTruncate,
+    Replay_simSync,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+};
+
+
+
+static void Replay_onRead (FileManager* file, Stream* stream, FileManager_CommandHeader* command) {
+    (void)file;
+    (void)command;
+    while (Stream_available(stream) > 0) {
+        Stream_readBytes(stream, scratch, Stream_available(stream) < (int32_t)sizeof(scratch) ? Stream_available(stream) : (int32_t)sizeof(scratch));
+    }
+}
+
+static void Replay_onComplete (FileManager* file, FileManager_CommandHeader* command, FileManager_Result result) {
+    Replay_File* replay = (Replay_File*)file;
+    (void)command;
+    (void)result;
+    if (Stream_available(&file->ReadStream) == 0) {
+        Stream_clear(&file->ReadStream);                    ///// read chunks go to write pointer, keep them from end of ReadStream
+    }
+    if (replay->Count == 0) {
+        return;
+    }
+    latencies[latencyCount++] = (uint32_t)(nowUs - replay->Queued[replay->Head]);
+    doneBytes               += replay->Lens[replay->Head];
+    lastDoneUs               = nowUs;
+    replay->Head             = (replay->Head + 1) % replay->Depth;
+    replay->Count--;
+}
+
+
+
+static int Replay_parse (const char* text) {
+    char        key[16];
+    char        value[16];
+    const char* p = text;
+    int         n;
+
+    config.Posix       = 0;
+    config.QueueDepth  = 16;
+    config.WriteBytes  = 4096;
+    config.ReadBytes   = 4096;
+    config.MaxSS       = 512;
+    config.Period      = 1000;
+    config.Passes      = 1;
+    config.Policy      = FileManager_SyncOnClose;
+    config.Threshold   = 0;
+    config.Latency     = 100;
+    config.Bandwidth   = 10;
+    config.SyncLatency = 2000;
+    config.Run         = 0;
+    config.MaxHold     = 0;
+    config.AllocUnit   = 0;
+    config.GcLatency   = 0;
+    while (*p != '\0') {
+        if (sscanf(p, "%15[^=]=%15[^,]%n", key, value, &n) != 2) {
+            return -1;
+        }
+        p += n;
+        if (*p == ',') {
+            p++;
+        }
+        if      (strcmp(key, "drv") == 0)    config.Posix       = strcmp(value, "posix") == 0;
+        else if (strcmp(key, "q") == 0)      config.QueueDepth  = (uint16_t)atoi(value);
+        else if (strcmp(key, "ws") == 0)     config.WriteBytes  = (uint16_t)atoi(value);
+        else if (strcmp(key, "rs") == 0)     config.ReadBytes   = (uint16_t)atoi(value);
+        else if (strcmp(key, "ss") == 0)     config.MaxSS       = (uint16_t)atoi(value);
+        else if (strcmp(key, "period") == 0) config.Period      = (uint32_t)(atof(value) * 1000);
+        else if (strcmp(key, "passes") == 0) config.Passes      = (uint16_t)atoi(value);
+        else if (strcmp(key, "thr") == 0)    config.Threshold   = (uint32_t)atoi(value);
+        else if (strcmp(key, "lat") == 0)    config.Latency     = (uint32_t)atoi(value);
+        else if (strcmp(key, "bw") == 0)     config.Bandwidth   = (uint32_t)atoi(value);
+        else if (strcmp(key, "sync") == 0)   config.SyncLatency = (uint32_t)atoi(value);
+        else if (strcmp(key, "run") == 0)    config.Run         = (uint32_t)atoi(value);
+        else if (strcmp(key, "hold") == 0)   config.MaxHold     = (uint32_t)atoi(value);
+        else if (strcmp(key, "au") == 0)     config.AllocUnit   = (uint32_t)atoi(value);
+        else if (strcmp(key, "gc") == 0)     config.GcLatency   = (uint32_t)atoi(value);
+        else if (strcmp(key, "policy") == 0) {
+            config.Policy = strcmp(value, "bytes") == 0    ? FileManager_SyncEveryBytes :
+                            strcmp(value, "time") == 0     ? FileManager_SyncEveryTime :
+                            strcmp(value, "cmd") == 0      ? FileManager_SyncEveryCommand :
+                            strcmp(value, "explicit") == 0 ? FileManager_SyncExplicit : FileManager_SyncOnClose;
+        }
+        else {
+            return -1;
+        }
+    }
+    if (config.QueueDepth == 0 || (config.QueueDepth & (config.QueueDepth - 1)) != 0 || config.MaxSS == 0 || config.Bandwidth == 0 ||
+        config.QueueDepth * sizeof(FileManager_CommandHeader) > UINT16_MAX) {
+        return -1;
+    }
+    return 0;
+}
+
+
+
+/**
+ * @brief queue one Record with dummy payload, return 0 if queue of File has no space (overflow),
+ *        Const Record is queued as Var copy of payload (Const Data of traced program is not in trace, pointer to it is not valid here)
+ */
+static int Replay_queue (const FileManagerTrace_Record* record) {
+    Replay_File* replay = &files[record->File];
+    FileManager* file   = &replay->File;
+    int32_t      need   = 0;
+
+    switch (record->Mode) {
+        case FileManager_WriteMode:
+            need = record->Len;
+            break;
+        case FileManager_FillMode:
+            need = 1;
+            break;
+        case FileManager_ReadMode:
+        case FileManager_MapReadMode:
+        case FileManager_StreamReadMode:
+            if (record->Len > config.ReadBytes) {
+                return 0;
+            }
+            break;
+    }
+    if (Queue_space(&file->CommandQueue) == 0 || Stream_space(&file->WriteStream) < need || replay->Count == replay->Depth) {
+        return 0;
+    }
+    switch (record->Mode) {
+        case FileManager_WriteMode:
+            File_write(file, (FileManager_Addr)record->Addr, payload, record->Len, FileManager_Var);
+            break;
+        case FileManager_FillMode:
+            File_fill(file, (FileManager_Addr)record->Addr, record->Len, 0);
+            break;
+        case FileManager_SyncMode:
+            File_flush(file);
+            break;
+        default:
+            File_read(file, (FileManager_Addr)record->Addr, record->Len);
+            break;
+    }
+    replay->Queued[(replay->Head + replay->Count) % replay->Depth] = nowUs;
+    replay->Lens[(replay->Head + replay->Count) % replay->Depth]   = record->Mode == FileManager_SyncMode ? 0 : record->Len;
+    replay->Count++;
+    return 1;
+}
+
+
+
+static int Replay_busy (void) {
+    uint8_t i;
+    for (i = 0; i < fileCount; i++) {
+        if (files[i].Count > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+
+static void Replay_handle (void) {
+    struct timespec start;
+    struct timespec end;
+    uint16_t        pass;
+    for (pass = 0; pass < config.Passes; pass++) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        FileManager_handle();
+        if (config.Posix) {
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            nowUs += (uint64_t)(end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+        }
+    }
+}
+
+
+
+static int Replay_compare (const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+
+
+static void Replay_run (const char* name, const FileManagerTrace_Record* records, uint32_t count) {
+    uint32_t  next      = 0;
+    uint32_t  overflow  = 0;
+    uint32_t  syncs     = 0;
+    uint32_t  skipped   = 0;
+    uint64_t  startUs;
+    uint64_t  nextHandle;
+    uint64_t  recordUs;
+    uint8_t   i;
+    double    seconds;
+
+    driver = config.Posix ? posixFileManagerDriver : simDriver;
+    driver.GetTimestamp = Replay_getTimestamp;
+    FileManager_Init(&driver);
+    fileConfig.MaxSS = config.MaxSS;
+    latencyCount     = 0;
+    doneBytes        = 0;
+    nowUs            = count > 0 ? (uint64_t)records[0].Time * 1000 : 0;
+    startUs          = nowUs;
+    lastDoneUs       = nowUs;
+    nextHandle       = nowUs;
+    for (i = 0; i < fileCount; i++) {
+        Replay_File* replay = &files[i];
+        uint32_t     cmd    = (uint32_t)config.QueueDepth * sizeof(FileManager_CommandHeader);
+        memset(&replay->File, 0, sizeof(replay->File));
+        replay->Posix   = (FileManager_PosixFil)FILE_MANAGER_POSIX_FIL_INIT;
+        memset(&replay->Sim, 0, sizeof(replay->Sim));
+        snprintf(replay->Path, sizeof(replay->Path), "/tmp/fmreplay-%u.bin", i);
+        remove(replay->Path);
+        replay->Depth   = config.QueueDepth + 2;               ///// queued commands and command in process
+        replay->Head    = 0;
+        replay->Count   = 0;
+        replay->Buffers = (uint8_t*)malloc(cmd * 2 + config.WriteBytes + config.ReadBytes);
+        replay->Queued  = (uint64_t*)malloc(replay->Depth * sizeof(uint64_t));
+        replay->Lens    = (int32_t*)malloc(replay->Depth * sizeof(int32_t));
+        FileManager_add(&replay->File, config.Posix ? (FileManager_Fil*)&replay->Posix : (FileManager_Fil*)&replay->Sim, &fileConfig, (uint8_t*)replay->Path);
+        File_init(&replay->File, replay->Buffers, cmd, replay->Buffers + cmd, cmd,
+                  replay->Buffers + cmd * 2, config.WriteBytes, replay->Buffers + cmd * 2 + config.WriteBytes, config.ReadBytes);
+        File_setSyncPolicy(&replay->File, (FileManager_SyncPolicy)config.Policy, config.Threshold);
+        File_setAlignment(&replay->File, config.Run, 0, config.MaxHold);
+        File_onRead(&replay->File, Replay_onRead);
+        File_onComplete(&replay->File, Replay_onComplete);
+    }
+
+    while (next < count || Replay_busy()) {
+        while (next < count && (uint64_t)records[next].Time * 1000 <= nowUs) {
+            if (records[next].File >= fileCount || records[next].Mode == FileManager_CopyMode ||
+                records[next].Mode == FileManager_LoggerReadMode || records[next].Mode == FileManager_WriteHeaderMode) {
+                skipped++;
+            }
+            else if (!Replay_queue(&records[next])) {
+                overflow++;
+            }
+            next++;
+        }
+        if (nowUs >= nextHandle) {
+            Replay_handle();
+            nextHandle += config.Period;
+            if (nextHandle < nowUs) {
+                nextHandle = nowUs;                             ///// handle task overrun its period
+            }
+            continue;
+        }
+        if (next == count && nowUs - lastDoneUs > REPLAY_STALL_US) {
+            fprintf(stderr, "%s: commands are not complete after %u s\n", name, REPLAY_STALL_US / 1000000);
+            break;
+        }
+        recordUs = next < count ? (uint64_t)records[next].Time * 1000 : nextHandle;
+        nowUs    = recordUs < nextHandle ? recordUs : nextHandle;
+    }
+
+    for (i = 0; i < fileCount; i++) {
+        syncs += File_getStats(&files[i].File)->SyncCount;
+        FileManager_remove(&files[i].File);
+        free(files[i].Buffers);
+        free(files[i].Queued);
+        free(files[i].Lens);
+        if (config.Posix) {
+            remove(files[i].Path);
+        }
+    }
+    qsort(latencies, latencyCount, sizeof(uint32_t), Replay_compare);
+    seconds = (double)(lastDoneUs - startUs) / 1e6;
+    printf("%-48s %8u %8u %8u %8u %9.2f %9.3f %9.3f %9.3f\n", name, latencyCount, overflow, skipped, syncs,
+           seconds > 0 ? doneBytes / seconds / 1e6 : 0.0,
+           latencyCount > 0 ? latencies[latencyCount / 2] / 1000.0 : 0.0,
+           latencyCount > 0 ? latencies[(uint32_t)(latencyCount * 0.99)] / 1000.0 : 0.0,
+           latencyCount > 0 ? latencies[latencyCount - 1] / 1000.0 : 0.0);
+}
+
+
+
+int main (int argc, char** argv) {
+    FileManagerTrace_Record* records;
+    uint8_t                  header[FILE_MANAGER_TRACE_HEADER_SIZE];
+    uint8_t                  data[FILE_MANAGER_TRACE_RECORD_SIZE];
+    uint32_t                 magic;
+    uint32_t                 count = 0;
+    uint32_t                 capacity = 1024;
+    int32_t                  maxLen = 1;
+    FILE*                    trace;
+    int                      i;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s trace.bin config...\n", argv[0]);
+        return 1;
+    }
+    trace = fopen(argv[1], "rb");
+    if (trace == NULL || fread(header, 1, sizeof(header), trace) != sizeof(header)) {
+        fprintf(stderr, "can not read %s\n", argv[1]);
+        return 1;
+    }
+    memcpy(&magic, header, sizeof(magic));
+    if (magic != FILE_MANAGER_TRACE_MAGIC || header[4] != FILE_MANAGER_TRACE_VERSION || header[5] != FILE_MANAGER_TRACE_RECORD_SIZE) {
+        fprintf(stderr, "%s is not a trace File\n", argv[1]);
+        return 1;
+    }
+    records = (FileManagerTrace_Record*)malloc(capacity * sizeof(*records));
+    while (fread(data, 1, sizeof(data), trace) == sizeof(data)) {
+        if (count == capacity) {
+            capacity *= 2;
+            records   = (FileManagerTrace_Record*)realloc(records, capacity * sizeof(*records));
+        }
+        FileManagerTrace_decode(data, &records[count]);
+        if (records[count].File >= fileCount && records[count].File < FILE_MANAGER_TRACE_FILES) {
+            fileCount = records[count].File + 1;
+        }
+        if (records[count].Len > maxLen) {
+            maxLen = records[count].Len;
+        }
+        count++;
+    }
+    fclose(trace);
+    payload   = (uint8_t*)calloc(maxLen, 1);
+    latencies = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+    printf("%u commands, %u Files, %.3f s\n", count, fileCount, count > 0 ? (records[count - 1].Time - records[0].Time) / 1000.0 : 0.0);
+    printf("%-48s %8s %8s %8s %8s %9s %9s %9s %9s\n", "config", "done", "overflow", "skipped", "syncs", "MB/s", "p50 ms", "p99 ms", "max ms");
+    for (i = 2; i < argc; i++) {
+        if (Replay_parse(argv[i]) != 0) {
+            fprintf(stderr, "bad config %s\n", argv[i]);
+            continue;
+        }
+        Replay_run(argv[i], records, count);
+    }
+    free(records);
+    free(payload);
+    free(latencies);
+    return 0;
+}